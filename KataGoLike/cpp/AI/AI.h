@@ -2,9 +2,12 @@
 
 #include "../GoGame/GoGame.h"
 
-class AI
+template<int N>
+class BasicAI
 {
 public:
-    virtual std::pair<int, int> move(const GoGame& game) = 0;
-    virtual ~AI() = default;
-};
\ No newline at end of file
+    virtual std::pair<int, int> move(const BasicGoGame<N>& game) = 0;
+    virtual ~BasicAI() = default;
+};
+
+typedef BasicAI<BOARD_SIZE> AI;
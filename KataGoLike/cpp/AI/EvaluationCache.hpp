@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include "../GoGame/GoGame.h"
+#include "../utils/FIFOCache.hpp"
+#include "../utils/Symmetry.hpp"
+
+/**
+ * @brief A thread safe cache of the evaluations of the network, the oldest position is removed when it is full.
+ *
+ * The features of a position only depend on the stones, the piece to move and the legal points, so they are the key.
+ * If it is canonical, the symmetric positions share one entry, the policy is kept in the canonical board
+ * and transformed back for every position.
+ * The class is a template on the board size N, EvaluationCache is the class of BOARD_SIZE.
+ */
+template<int N>
+class BasicEvaluationCache
+{
+public:
+    // The policy and the value of a position.
+    struct Evaluation
+    {
+        BasicOutputArray<N> policy;
+        float               value;
+    };
+
+    /**
+     * @brief Constructs an EvaluationCache.
+     * @param maxSize: the number of positions in the cache, it must be positive.
+     * @param canonical: whether the symmetric positions share one entry.
+     */
+    BasicEvaluationCache(std::size_t maxSize, bool canonical = CANONICAL_CACHE)
+        : _cache(maxSize), _canonical(canonical)
+    {
+    }
+
+    /**
+     * @brief Get the evaluation of a position from the cache.
+     * @param game: the position.
+     * @param policy: set to the policy if the position is in the cache.
+     * @param value: set to the value if the position is in the cache.
+     * @return bool: whether the position is in the cache.
+     */
+    bool tryGet(const BasicGoGame<N>& game, BasicOutputArray<N>& policy, float& value)
+    {
+        auto [key, transform] = getKey(game);
+        Evaluation evaluation;
+        bool found;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            found = _cache.tryGet(key, evaluation);
+        }
+        if (!found)
+        {
+            _misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        policy = (transform == 0) ? evaluation.policy : transformPolicy<N>(evaluation.policy, inverseTransform(transform));
+        value  = evaluation.value;
+        return true;
+    }
+
+    /**
+     * @brief Put the evaluation of a position into the cache.
+     * @param game: the position.
+     * @param policy: the policy of the position.
+     * @param value: the value of the position.
+     */
+    void put(const BasicGoGame<N>& game, const BasicOutputArray<N>& policy, float value)
+    {
+        auto [key, transform] = getKey(game);
+        Evaluation evaluation{(transform == 0) ? policy : transformPolicy<N>(policy, transform), value};
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache.put(key, evaluation);
+    }
+
+    std::size_t hits() const   { return _hits.load(std::memory_order_relaxed); }
+    std::size_t misses() const { return _misses.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the ratio of the lookups which find the position.
+     * @return double: the hit rate, 0 before any lookup.
+     */
+    double hitRate() const
+    {
+        auto lookups = hits() + misses();
+        return lookups == 0 ? 0 : static_cast<double>(hits()) / lookups;
+    }
+
+    std::size_t size()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache.size();
+    }
+
+    std::size_t maxSize()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache.maxSize();
+    }
+
+    /**
+     * @brief Estimate the memory of the entries, a hash map node and a queue element for each.
+     * @return std::size_t: the bytes.
+     */
+    std::size_t memoryBytes()
+    {
+        return size() * (sizeof(uint64_t) * 2 + sizeof(Evaluation) + sizeof(void*) * 2);
+    }
+
+private:
+    FIFOCache<uint64_t, Evaluation, std::hash<uint64_t>> _cache;
+    bool                     _canonical;
+    std::mutex               _mutex{};
+    std::atomic<std::size_t> _hits{0};
+    std::atomic<std::size_t> _misses{0};
+
+    /**
+     * @brief Get the key of the features of a position, and the transform of its board in the cache.
+     * @param game: the position.
+     * @return CanonicalHash: the key and the transform, 0 if the cache is not canonical.
+     */
+    CanonicalHash getKey(const BasicGoGame<N>& game) const
+    {
+        CanonicalHash board = _canonical ? game.canonicalHash() : CanonicalHash{game.hash(), 0};
+        // the piece to move and the legal points, the legal points have the KO ban, after the same transform as the stones
+        uint64_t state = (game.getNowPiece() == Player::White) ? 1 : 0;
+        uint64_t key   = board.hash ^ splitMix64(state);
+        for (auto legal = game.getLegalMask(); legal; legal &= legal - 1)
+        {
+            uint64_t point = static_cast<uint64_t>(SYMMETRY_TABLE<N>[board.transform][lowestPoint(legal)] + 1) << 40;
+            key ^= splitMix64(point);
+        }
+        return {key, board.transform};
+    }
+};
+
+typedef BasicEvaluationCache<BOARD_SIZE> EvaluationCache;
@@ -1,72 +1,65 @@
+#include <algorithm>
+
 #include "ExhaustiveTree.h"
 
-std::atomic<bool> ExhaustiveTree::Node::finished = true;
-std::atomic<int> ExhaustiveTree::Node::count = 0;
+template<int N>
+std::atomic<bool> BasicExhaustiveTree<N>::Node::finished = true;
+template<int N>
+std::atomic<int> BasicExhaustiveTree<N>::Node::count = 0;
+template<int N>
+std::atomic<bool> BasicExhaustiveTree<N>::Node::incomplete = false;
 
-ExhaustiveTree::Node::Node(GoGame state)
+template<int N>
+BasicExhaustiveTree<N>::Node::Node(GoGame& state)
 {
-    if (finished) return;
+    if (finished)
+    {
+        incomplete = true;
+        return;
+    }
     if (count++ > MAX_COUNT)
     {
         finished = true;
+        incomplete = true;
         return;
     }
 
-    _state = state;
     _move = std::make_pair(-1, -1);
+    solve(state);
+}
 
-    if (_state.isGameOver())
+template<int N>
+BasicExhaustiveTree<N>::Node::Node(GoGame& state, std::pair<int, int> move)
+{
+    if (finished)
     {
-        _winner = _state.judgeWinner();
+        incomplete = true;
         return;
     }
-
-    auto moves = _state.getPossiblePlacements();
-    _children.clear();
-    _children.reserve(moves.size() + 1);
-
-    for (int i = 0; i < moves.size() + 1; i++)
-    {
-        if (i == 0)
-        {
-            _children.emplace_back(_state, std::make_pair(-1, -1));
-        }
-        else
-        {
-            _children.emplace_back(_state, moves[i - 1]);
-        }
-        // 任意方式能赢，则当前节点能赢
-        if (_children[i]._winner == _state.getNowPiece())
-        {
-            _winner = _state.getNowPiece();
-            return;
-        }
-    }
-
-    // 如果所有方式都不能赢，则当前节点不能赢
-    _winner = _state.getNowPiece() == Player::Black ? Player::White : Player::Black;
-}
-
-ExhaustiveTree::Node::Node(GoGame state, std::pair<int, int> move)
-{
-    if (finished) return;
     if (count++ > MAX_COUNT)
     {
         finished = true;
+        incomplete = true;
         return;
     }
 
-    _state = state;
     _move = move;
-    _state.move(_move.first, _move.second);
+    typename GoGame::UndoRecord record;
+    state.makeMove(_move.first, _move.second, record);
+    solve(state);
+    state.undoMove(record);
+}
 
-    if (_state.isGameOver())
+template<int N>
+void BasicExhaustiveTree<N>::Node::solve(GoGame& state)
+{
+    if (state.isGameOver())
     {
-        _winner = _state.judgeWinner();
+        _winner = state.judgeWinner();
         return;
     }
 
-    auto moves = _state.getPossiblePlacements();
+    auto moves = state.getPossiblePlacements();
     _children.clear();
     _children.reserve(moves.size() + 1);
 
@@ -74,56 +67,86 @@ ExhaustiveTree::Node::Node(GoGame state, std::pair<int, int> move)
     {
         if (i == 0)
         {
-            _children.emplace_back(_state, std::make_pair(-1, -1));
+            _children.emplace_back(state, std::make_pair(-1, -1));
         }
         else
         {
-            _children.emplace_back(_state, moves[i - 1]);
+            _children.emplace_back(state, moves[i - 1]);
         }
         // 任意方式能赢，则当前节点能赢
-        if (_children[i]._winner == _state.getNowPiece())
+        if (_children[i]._winner == state.getNowPiece())
         {
-            _winner = _state.getNowPiece();
+            _winner = state.getNowPiece();
             return;
         }
     }
 
     // 如果所有方式都不能赢，则当前节点不能赢
-    _winner = _state.getNowPiece() == Player::Black ? Player::White : Player::Black;
+    _winner = state.getNowPiece() == Player::Black ? Player::White : Player::Black;
 }
 
-ExhaustiveTree::ExhaustiveTree(GoGame state)
+template<int N>
+BasicExhaustiveTree<N>::BasicExhaustiveTree(GoGame state)
 {
     _state = state;
 }
 
-std::optional<std::pair<int, int>> ExhaustiveTree::getMustWinMove()
+template<int N>
+std::optional<std::pair<int, int>> BasicExhaustiveTree<N>::getMustWinMove()
 {
-    if (_state.getNMove() < 14)
+    // only the end of a game is small enough to search
+    if (_state.getNMove() < N * N - 11)
     {
         return std::nullopt;
     }
 
     Node::finished = false;
+    Node::incomplete = false;
     Node::count = 0;
 
     root = Node(_state);
 
+    // the winners of a stopped search are not known, the nodes made after the stop are empty
+    if (Node::incomplete)
+    {
+        _outcome = Outcome::STOPPED;
+        return std::nullopt;
+    }
+
     if(root._winner == _state.getNowPiece())
     {
         for (auto child : root._children)
         {
             if (child._winner == _state.getNowPiece())
             {
+                _outcome = Outcome::WIN;
                 return std::make_optional(child._move);
             }
                 
         }
     }
+    _outcome = Outcome::NO_WIN;
     return std::nullopt;
 }
 
-void ExhaustiveTree::stop()
+template<int N>
+void BasicExhaustiveTree<N>::stop()
 {
     Node::finished = true;
-}
\ No newline at end of file
+}
+
+template<int N>
+typename BasicExhaustiveTree<N>::Outcome BasicExhaustiveTree<N>::getOutcome() const
+{
+    return _outcome;
+}
+
+template<int N>
+int BasicExhaustiveTree<N>::getNodeCount() const
+{
+    return _outcome == Outcome::NOT_RUN ? 0 : std::min(Node::count.load(), static_cast<int>(Node::MAX_COUNT));
+}
+
+template class BasicExhaustiveTree<5>;
+template class BasicExhaustiveTree<7>;
+template class BasicExhaustiveTree<9>;
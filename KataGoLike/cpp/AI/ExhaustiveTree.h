@@ -1,37 +1,58 @@
 #pragma once
 
 #include <atomic>
+#include <optional>
 
 #include "../GoGame/GoGame.h"
 
-class ExhaustiveTree
+template<int N>
+class BasicExhaustiveTree
 {
+public:
+    // How the last getMustWinMove ended.
+    enum class Outcome { NOT_RUN, WIN, NO_WIN, STOPPED };
+
 private:
+    typedef BasicGoGame<N> GoGame;
+
     class Node
     {
-    friend ExhaustiveTree;
+    friend BasicExhaustiveTree;
     private:
-        GoGame _state;
         std::pair<int, int> _move;
         Player _winner;
         std::vector<Node> _children{};
         static std::atomic<bool> finished;
         static std::atomic<int> count;
+        // whether a node was left empty by the stop, then the winners are not known
+        static std::atomic<bool> incomplete;
         static const int MAX_COUNT = 500000;
+
+        // search the children of the node, state is the game after _move
+        void solve(GoGame& state);
     public:
         Node() = default;
-        Node(GoGame state);
-        Node(GoGame state, std::pair<int, int> _move);
+        // state is walked by the whole search, it is the same as before when the constructor returns
+        Node(GoGame& state);
+        Node(GoGame& state, std::pair<int, int> _move);
         ~Node() = default;
     };
 
-    GoGame _state;
-    Node   root;
+    GoGame  _state;
+    Node    root;
+    Outcome _outcome = Outcome::NOT_RUN;
     
 public:
-    ExhaustiveTree(GoGame state);
+    BasicExhaustiveTree(GoGame state);
     std::optional<std::pair<int, int>> getMustWinMove();
     void stop();
-    ~ExhaustiveTree() = default;
+
+    // NOT_RUN if the game is too early, STOPPED if stop or the node limit ended the search before it was solved
+    Outcome getOutcome() const;
+    // the nodes made by the last getMustWinMove
+    int getNodeCount() const;
+    ~BasicExhaustiveTree() = default;
 };
 
+typedef BasicExhaustiveTree<BOARD_SIZE> ExhaustiveTree;
+
@@ -1,22 +1,30 @@
 #include <random>
 #include <chrono>
 #include <future>
+#include <thread>
+#include <new>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
 
 #include"MCTSAI.h"
 #include"ExhaustiveTree.h"
 
-InputArray getFeatures(const GoGame& game)
+template<int N>
+BasicInputArray<N> getFeatures(const BasicGoGame<N>& game)
 {
-    InputArray input  = {0};
+    BasicInputArray<N> input  = {0};
 
     int thisPlayer = game.getNowPiece() == Player::Black ? 1 : -1;
-    Stone thisStone = game.getNowPiece() == Player::Black ? Stone::Black : Stone::White;
-    for (int i = 0; i < BOARD_SIZE; i++)
+    auto legal = game.getLegalMask();
+    for (int i = 0; i < N; i++)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        for (int j = 0; j < N; j++)
         {
             Stone stone = game.getStone(i, j);
-            if (game.isLegal(i, j, thisStone))
+            if (legal & pointMask<N>(i, j))
             {
                 input[4][i][j] = thisPlayer;
             }
@@ -35,57 +43,214 @@ InputArray getFeatures(const GoGame& game)
     return input;
 }
 
-InferenceEngine::InferenceEngine(std::unique_ptr<NeuralNetworkInferenceEngine>&& engine)
+/**
+ * @brief Add to an atomic float, std::atomic<float> has no fetch_add before C++20.
+ * @param target: the atomic float.
+ * @param value: the value to add.
+ */
+inline void atomicAdd(std::atomic<float>& target, float value)
+{
+    float expected = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * @brief Get the name of the outcome of an exhaustive search, for the search stats.
+ * @param outcome: the outcome.
+ * @return const char*: not_run, win, no_win or stopped.
+ */
+template<int N>
+const char* outcomeName(typename BasicExhaustiveTree<N>::Outcome outcome)
+{
+    switch (outcome)
+    {
+        case BasicExhaustiveTree<N>::Outcome::WIN:     return "win";
+        case BasicExhaustiveTree<N>::Outcome::NO_WIN:  return "no_win";
+        case BasicExhaustiveTree<N>::Outcome::STOPPED: return "stopped";
+        default:                                       return "not_run";
+    }
+}
+
+/**
+ * @brief Check whether two games are in the same position, so a search tree of one can be used for the other.
+ * @param game1: the first game.
+ * @param game2: the second game.
+ * @return bool: whether the stones, the player to move, the move number and the legal points are the same.
+ */
+template<int N>
+bool samePosition(const BasicGoGame<N>& game1, const BasicGoGame<N>& game2)
+{
+    return game1.hash()          == game2.hash()
+        && game1.getNowPiece()   == game2.getNowPiece()
+        && game1.getNMove()      == game2.getNMove()
+        && game1.isGameOver()    == game2.isGameOver()
+        && game1.getLegalMask()  == game2.getLegalMask();
+}
+
+template<int N>
+std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>> makeSearchEngine(const char* onnxPath, unsigned int threadNum, unsigned int searchThreadNum)
+{
+    auto engine = std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>(std::make_unique<BasicONNXEngine<N>>(onnxPath, threadNum));
+    if (searchThreadNum == 0) searchThreadNum = std::max(1u, std::thread::hardware_concurrency());
+    // a single search thread has nobody to share a batch with
+    if (searchThreadNum == 1) return engine;
+    auto batchSize = std::min<size_t>(searchThreadNum, DEFAULT_MAX_BATCH_SIZE);
+    return std::make_unique<BasicBatchInferenceEngine<N>>(std::move(engine), batchSize);
+}
+
+template<int N>
+BasicInferenceEngine<N>::BasicInferenceEngine(std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>&& engine, std::size_t cacheSize)
 {
     _engine = std::move(engine);
+    setCacheSize(cacheSize);
 }
 
-OutputArray InferenceEngine::inference(const GoGame& game)
+template<int N>
+BasicOutputArray<N> BasicInferenceEngine<N>::inference(const BasicGoGame<N>& game)
 {
-    InputArray input  = getFeatures(game);
-    OutputArray output = {0};
+    float value = 0.5f;
+    return inference(game, value);
+}
+
+template<int N>
+BasicOutputArray<N> BasicInferenceEngine<N>::inference(const BasicGoGame<N>& game, float& value)
+{
+    BasicOutputArray<N> output = {0};
+    if (_cache != nullptr && _cache->tryGet(game, output, value)) return output;
 
-    _engine->inference(input, output);
+    BasicInputArray<N>  input  = getFeatures(game);
+    // the value is always asked for, so an entry of the cache has both
+    auto startTime = std::chrono::steady_clock::now();
+    _engine->inference((float *)input.data(), (float *)output.data(), &value, 1);
+    _inferenceNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+    _inferenceCalls++;
+    if (_cache != nullptr) _cache->put(game, output, value);
     return output;
 }
 
-MCTNode* MCTNode::selectBestChild()
+template<int N>
+void BasicInferenceEngine<N>::setCacheSize(std::size_t cacheSize)
+{
+    if (cacheSize == 0)
+        _cache = nullptr;
+    else
+        _cache = std::make_unique<BasicEvaluationCache<N>>(cacheSize);
+}
+
+template<int N>
+BasicEvaluationCache<N>* BasicInferenceEngine<N>::getCache()
 {
-    if (_children.empty()) return nullptr;
-    MCTNode* bestChild = nullptr;
-    float bestPUCT = std::numeric_limits<float>::lowest();
-    for (auto child : _children)
+    return _cache.get();
+}
+
+template<int N>
+std::size_t BasicInferenceEngine<N>::getInferenceCalls() const
+{
+    return _inferenceCalls;
+}
+
+template<int N>
+std::chrono::nanoseconds BasicInferenceEngine<N>::getInferenceTime() const
+{
+    return std::chrono::nanoseconds(_inferenceNanoseconds);
+}
+
+template<int N>
+bool BasicInferenceEngine<N>::hasValue() const
+{
+    return _engine->hasValue();
+}
+
+template<int N>
+int BasicMCTNode<N>::selectBestChild() const
+{
+    const Children& children = *_children;
+    int parentVisitTimes = _visitTimes;
+    int size = children.size;
+    // only the children with the highest priors can be selected, more of them as the node is visited
+    if constexpr (USE_PROGRESSIVE_WIDENING)
+        size = std::min(size, 1 + static_cast<int>(WIDENING_C * std::pow(parentVisitTimes, WIDENING_ALPHA)));
+
+    // the children have the wins of the player who moved into them, the player to move here
+    const auto& winTimes = (_state.getNowPiece() == Player::Black) ? children.blackWinTimes : children.whiteWinTimes;
+
+    // the counters are read once. A visit which is still running below a child is already in its visits without a win,
+    // so it counts as one loss, the rest of the VIRTUAL_LOSS of every such visit is added. So the threads spread over the children
+    std::array<float, Children::CAPACITY> visits;
+    std::array<float, Children::CAPACITY> wins;
+    std::array<float, Children::CAPACITY> winVisits;
+    // a move which is proven to lose is only selected when all moves lose, then the node is proven too
+    std::array<float, Children::CAPACITY> penalties;
+    for (int k = 0; k < size; k++)
     {
-        // FORCED SELECT
-        if (_isForceSelect && child->_visitTimes < sqrt(FORCE_SELECT_K * _visitTimes))
-            return child;
-        float PUCT = child->getPUCT();
-        if (PUCT > bestPUCT)
+        int visitTimes = children.visitTimes[k].load(std::memory_order_relaxed)
+                       + (VIRTUAL_LOSS - 1) * children.virtualLoss[k].load(std::memory_order_relaxed);
+        visits[k]    = visitTimes;
+        wins[k]      = winTimes[k].load(std::memory_order_relaxed);
+        penalties[k] = 0;
+        if constexpr (USE_TRANSPOSITION_TABLE || USE_MCTS_SOLVER)
         {
-            bestPUCT = PUCT;
-            bestChild = child;
+            const MCTNode* node = children.nodes[k].load(std::memory_order_acquire);
+            // the win rate is of the node of the position, it is shared by all parents
+            if (USE_TRANSPOSITION_TABLE && node != nullptr)
+            {
+                wins[k]    = (_state.getNowPiece() == Player::Black) ? node->_blackWinTimes : node->_whiteWinTimes;
+                visitTimes = node->_visitTimes + (VIRTUAL_LOSS - 1) * node->_virtualLoss;
+            }
+            if (USE_MCTS_SOLVER && node != nullptr && node->_proof.load(std::memory_order_relaxed) == opponentProof())
+                penalties[k] = LOST_MOVE_PENALTY;
+        }
+        // an unvisited child has no wins, its win rate is 0
+        winVisits[k] = std::max(visitTimes, 1);
+    }
+
+    // FORCED SELECT
+    if (_isForceSelect)
+    {
+        float forcedVisitTimes = sqrt(FORCE_SELECT_K * parentVisitTimes);
+        for (int k = 0; k < size; k++)
+        {
+            if (penalties[k] == 0 && children.visitTimes[k].load(std::memory_order_relaxed) < forcedVisitTimes)
+                return k;
         }
     }
+
+    // the PUCT of all children in one loop without branches
+    float exploration = C_PUCT * sqrt(parentVisitTimes);
+    std::array<float, Children::CAPACITY> PUCT;
+    for (int k = 0; k < size; k++)
+    {
+        PUCT[k] = wins[k] / winVisits[k] + exploration * children.priors[k] / (1 + visits[k]) + penalties[k];
+    }
+
+    int bestChild = 0;
+    for (int k = 1; k < size; k++)
+    {
+        if (PUCT[k] > PUCT[bestChild]) bestChild = k;
+    }
     return bestChild;
 }
 
-std::pair<int, int> MCTNode::randomAction(const std::vector<std::pair<int, int>>& actions,
-                                          const std::vector<float>& probs)
+template<int N>
+std::pair<int, int> BasicMCTNode<N>::randomAction(const MoveList& actions,
+                                          const ProbabilityList& probs)
 {
     if (actions.size() != probs.size()) return {-1, -1};
     
     float sum = 0;
-    std::vector<float> cumulativeWeights(probs.size());
+    ProbabilityList cumulativeWeights{};
     for (int i = 0; i < probs.size(); i++)
     {
         sum += probs[i];
-        cumulativeWeights[i] = sum;
+        cumulativeWeights.push_back(sum);
     }
 
     if (sum == 0) return {-1, -1};
 
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    // every search thread has its own generator
+    static thread_local std::mt19937 gen(std::random_device{}());
 
     std::uniform_real_distribution<> distrib(0.0, sum);
     double randomWeight = distrib(gen);
@@ -96,139 +261,313 @@ std::pair<int, int> MCTNode::randomAction(const std::vector<std::pair<int, int>>
     return actions[index];
 }
 
-MCTNode::MCTNode(const GoGame& game, InferenceEngine* engine, bool forceSelect)
+template<int N>
+BasicMCTNode<N>::BasicMCTNode(const GoGame& game, InferenceEngine* engine, TreeArena* arena, bool forceSelect)
+    : _state(game)
 {
-    this->_parent = nullptr;
-    this->_children = {};
-    this->_state = game;
-    this->_action = {-1, -1};
-    this->_P = 0;
+    this->_children = nullptr;
     this->_visitTimes = 0;
     this->_blackWinTimes = 0;
     this->_whiteWinTimes = 0;
+    this->_virtualLoss = 0;
+    this->_expandState = NOT_EXPANDED;
+    this->_proof = proofOf(_state);
     this->_engine = engine;
+    this->_arena = arena;
     this->_isForceSelect = forceSelect;
 }
 
-MCTNode::MCTNode(MCTNode* parent, std::pair<int, int> action, InferenceEngine* engine, float P)
+template<int N>
+BasicMCTNode<N>::BasicMCTNode(const GoGame& parentState, std::pair<int, int> action, InferenceEngine* engine, TreeArena* arena)
+    : BasicMCTNode(parentState, engine, arena, false)
 {
-    this->_parent = parent;
-    this->_children = {};
-    this->_state = parent->_state;
-    this->_state.move(action.first, action.second);
-    this->_action = action;
-    this->_P = P;
-    this->_visitTimes = 0;
-    this->_blackWinTimes = 0;
-    this->_whiteWinTimes = 0;
-    this->_engine = engine;
-    this->_isForceSelect = false;
+    _state.move(action.first, action.second);
+    _proof = proofOf(_state);
 }
 
-MCTNode::~MCTNode()
+template<int N>
+int BasicMCTNode<N>::proofOf(const GoGame& game)
 {
-    for (auto child : _children)
-    {
-        delete child;
-    }
+    // only the end of the game is proven when the node is made, the other nodes are proven by their children
+    if (!USE_MCTS_SOLVER || !game.isGameOver()) return UNPROVEN;
+    return (game.judgeWinner() == Player::Black) ? BLACK_WINS : WHITE_WINS;
 }
 
-float MCTNode::getPUCT() const
+template<int N>
+int BasicMCTNode<N>::ownProof() const
 {
-    if (_parent == nullptr) return 0;
+    return (_state.getNowPiece() == Player::Black) ? BLACK_WINS : WHITE_WINS;
+}
+
+template<int N>
+int BasicMCTNode<N>::opponentProof() const
+{
+    return (_state.getNowPiece() == Player::Black) ? WHITE_WINS : BLACK_WINS;
+}
+
+template<int N>
+bool BasicMCTNode<N>::isProven() const
+{
+    return _proof.load(std::memory_order_acquire) != UNPROVEN;
+}
+
+template<int N>
+bool BasicMCTNode<N>::isWon() const
+{
+    return _proof.load(std::memory_order_acquire) == ownProof();
+}
 
-    if (_visitTimes == 0)
+template<int N>
+bool BasicMCTNode<N>::isLostChild(int k) const
+{
+    const MCTNode* node = _children->nodes[k].load(std::memory_order_acquire);
+    return node != nullptr && node->_proof.load(std::memory_order_acquire) == opponentProof();
+}
+
+template<int N>
+int BasicMCTNode<N>::getChildNum() const
+{
+    return isExpanded() ? _children->size : 0;
+}
+
+template<int N>
+int BasicMCTNode<N>::getChildVisitTimes(int k) const
+{
+    return _children->visitTimes[k].load(std::memory_order_relaxed);
+}
+
+template<int N>
+bool BasicMCTNode<N>::prove(int k)
+{
+    if (isProven()) return false;
+
+    // one winning move proves a win
+    const MCTNode* child = _children->nodes[k].load(std::memory_order_acquire);
+    if (child->_proof.load(std::memory_order_acquire) == ownProof())
     {
-        return 0 + C_PUCT * _P * sqrt(_parent->_visitTimes) / (1 + _visitTimes);
+        _proof.store(ownProof(), std::memory_order_release);
+        return true;
     }
-    
-    if (_state.getNowPiece() == Player::Black)
+
+    // a loss needs every move to lose
+    for (int i = 0; i < _children->size; i++)
     {
-        return (float)(_whiteWinTimes) / _visitTimes + C_PUCT * _P * sqrt(_parent->_visitTimes) / (1 + _visitTimes);
+        const MCTNode* other = _children->nodes[i].load(std::memory_order_acquire);
+        if (other == nullptr || other->_proof.load(std::memory_order_acquire) != opponentProof()) return false;
+    }
+    _proof.store(opponentProof(), std::memory_order_release);
+    return true;
+}
+
+template<int N>
+BasicMCTNode<N>* BasicMCTNode<N>::child(int k)
+{
+    auto& slot = _children->nodes[k];
+    MCTNode* node = slot.load(std::memory_order_acquire);
+    if (node != nullptr) return node;
+
+    if constexpr (USE_TRANSPOSITION_TABLE)
+    {
+        // the position is looked up before a node is made, so a transposition takes no memory of the arena,
+        // and it is found even when the arena is full
+        GoGame state = _state;
+        auto [i, j] = _children->actions[k];
+        state.move(i, j);
+        node = _arena->transpositions.find(state.positionKey());
+        if (node == nullptr)
+        {
+            auto memory = _arena->nodes.allocate(1);
+            if (memory == nullptr) return slot.load(std::memory_order_acquire);
+            // the first node of a position is kept in the table, the other parents share it
+            node = _arena->transpositions.insert(state.positionKey(), new (memory) MCTNode(state, _engine, _arena, false));
+        }
     }
     else
     {
-        return (float)(_blackWinTimes) / _visitTimes + C_PUCT * _P * sqrt(_parent->_visitTimes) / (1 + _visitTimes);
+        auto memory = _arena->nodes.allocate(1);
+        // the tree is full, a node made by another thread may still be there
+        if (memory == nullptr) return slot.load(std::memory_order_acquire);
+        node = new (memory) MCTNode(_state, _children->actions[k], _engine, _arena);
     }
+    // if another thread has made the child at the same time, its one is kept
+    MCTNode* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, node, std::memory_order_acq_rel))
+        return node;
+    return expected;
 }
 
-bool MCTNode::isRoot() const
+template<int N>
+bool BasicMCTNode<N>::isExpanded() const
 {
-    return _parent == nullptr;
+    return _expandState.load(std::memory_order_acquire) == EXPANDED;
 }
 
-void MCTNode::expand()
+template<int N>
+bool BasicMCTNode<N>::expand()
 {
-    if (!_children.empty()) return;
+    // only one thread expands the node, the others wait for its children
+    int expected = NOT_EXPANDED;
+    if (!_expandState.compare_exchange_strong(expected, EXPANDING, std::memory_order_acq_rel))
+    {
+        while (_expandState.load(std::memory_order_acquire) == EXPANDING) std::this_thread::yield();
+        return isExpanded();
+    }
     
     OutputArray policy = {0};
     if constexpr (USE_NEURAL_NETWORK)
         policy = _engine->inference(_state);
+    return createChildren(policy);
+}
+
+template<int N>
+bool BasicMCTNode<N>::createChildren(const OutputArray& policy)
+{
+    auto memory = _arena->children.allocate(1);
+    if (memory == nullptr)
+    {
+        _expandState.store(LEAF, std::memory_order_release);
+        return false;
+    }
 
     auto moves = _state.getPossiblePlacements();
-    for (auto move : moves)
+    Children* children = new (memory) Children;
+    children->size = moves.size() + 1;
+    // only the counters of the children are set to zero, not the whole capacity
+    for (int k = 0; k < children->size; k++)
+    {
+        children->visitTimes[k].store(0, std::memory_order_relaxed);
+        children->virtualLoss[k].store(0, std::memory_order_relaxed);
+        children->blackWinTimes[k].store(0, std::memory_order_relaxed);
+        children->whiteWinTimes[k].store(0, std::memory_order_relaxed);
+        children->nodes[k].store(nullptr, std::memory_order_relaxed);
+    }
+    for (int k = 0; k < moves.size(); k++)
     {
+        children->actions[k] = moves[k];
         if constexpr (USE_NEURAL_NETWORK)
-            _children.push_back(
-                new MCTNode(this, move, _engine, policy[boardPairToInt(move)]));
+            children->priors[k] = policy[boardPairToInt<N>(moves[k])];
         else
-            _children.push_back(
-                new MCTNode(this, move, _engine, 1.0f / (moves.size() + 1)));
+            children->priors[k] = 1.0f / (moves.size() + 1);
     }
     // you can always pass
+    children->actions[moves.size()] = {-1, -1};
     if constexpr (USE_NEURAL_NETWORK)
-        _children.push_back(
-            new MCTNode(this, {-1, -1}, _engine, policy[BOARD_SIZE * BOARD_SIZE]));
+        children->priors[moves.size()] = policy[N * N];
     else
-        _children.push_back(
-            new MCTNode(this, {-1, -1}, _engine, 1.0f / (moves.size() + 1)));
-}
+        children->priors[moves.size()] = 1.0f / (moves.size() + 1);
 
-void MCTNode::select()
-{
-    _visitTimes += 1;
-    
-    // if children is not empty, select the one child
-    if (!_children.empty())
+    if constexpr (USE_PROGRESSIVE_WIDENING)
     {
-        selectBestChild()->select();
-        return;
+        // the children are widened in the order of their priors, so they are sorted once here
+        std::array<int, Children::CAPACITY> order;
+        std::iota(order.begin(), order.begin() + children->size, 0);
+        std::stable_sort(order.begin(), order.begin() + children->size,
+                         [children](int a, int b) { return children->priors[a] > children->priors[b]; });
+        auto actions = children->actions;
+        auto priors  = children->priors;
+        for (int k = 0; k < children->size; k++)
+        {
+            children->actions[k] = actions[order[k]];
+            children->priors[k]  = priors[order[k]];
+        }
     }
+    _children = children;
+
+    _expandState.store(EXPANDED, std::memory_order_release);
+    return true;
+}
 
-    // if game is over, backpropagate
-    if (_state.isGameOver())
+template<int N>
+int BasicMCTNode<N>::select()
+{
+    // the nodes of this visit and the child taken from each of them, the result goes back along them
+    FixedVector<std::pair<MCTNode*, int>, N * N + 1> path{};
+    MCTNode* node = this;
+    Result result;
+    while (true)
     {
-        if (_state.judgeWinner() == Player::Black)
+        int visitTimes = ++node->_visitTimes;
+        node->_virtualLoss++;
+
+        // a solved position has its result without a search below it
+        if (USE_MCTS_SOLVER && node->isProven())
         {
-            setResult(1, 0);
+            if (node->_proof.load(std::memory_order_acquire) == BLACK_WINS)
+                result = {1, 0};
+            else
+                result = {0, 1};
+            break;
         }
-        else
+        // if game is over, backpropagate
+        if (node->_state.isGameOver())
+        {
+            if (node->_state.judgeWinner() == Player::Black)
+                result = {1, 0};
+            else
+                result = {0, 1};
+            break;
+        }
+        if (!node->isExpanded())
+        {
+            // if is the first time to visit this node, or the tree is full, evaluate it with the value of the model, or rollout
+            if (visitTimes == 1 || !node->expand())
+            {
+                if (USE_NEURAL_NETWORK && USE_VALUE_HEAD && _engine->hasValue())
+                    result = node->evaluate();
+                else
+                    result = node->rollout();
+                break;
+            }
+        }
+
+        int k = node->selectBestChild();
+        node->_children->visitTimes[k]++;
+        node->_children->virtualLoss[k]++;
+        path.push_back({node, k});
+        MCTNode* next = node->child(k);
+        // the tree is full, the position after the move is the leaf without a node
+        if (next == nullptr)
         {
-            setResult(0, 1);
+            GoGame game = node->_state;
+            auto [i, j] = node->_children->actions[k];
+            game.move(i, j);
+            result = estimate(game);
+            node = nullptr;
+            break;
         }
-        return;
+        node = next;
     }
 
-    // if is the first time to visit this node, rollout
-    if (_visitTimes == 1)
+    // in the DAG mode the leaf and the nodes of the path may have other parents, only this path is updated.
+    // It goes from the leaf up, so the proof of the leaf can prove its parents one by one
+    bool proving = false;
+    if (node != nullptr)
     {
-        rollout();
-        return;
+        node->setResult(result.first, result.second);
+        proving = USE_MCTS_SOLVER && node->isProven();
     }
-    // else expand, and select the best child
-    else
+    for (int i = static_cast<int>(path.size()) - 1; i >= 0; i--)
     {
-        expand();
-        selectBestChild()->select();
-        return;
+        auto [parent, k] = path[i];
+        Children& children = *parent->_children;
+        atomicAdd(children.blackWinTimes[k], result.first);
+        atomicAdd(children.whiteWinTimes[k], result.second);
+        children.virtualLoss[k]--;
+        parent->setResult(result.first, result.second);
+        if (proving) proving = parent->prove(k);
     }
+    return path.size();
 }
 
-void MCTNode::rollout()
+template<int N>
+typename BasicMCTNode<N>::Result BasicMCTNode<N>::rollout()
+{
+    return rollout(_state);
+}
+
+template<int N>
+typename BasicMCTNode<N>::Result BasicMCTNode<N>::rollout(GoGame game)
 {
-    // copy 
-    GoGame game = _state;
-    
     while (!game.isGameOver())
     {
         OutputArray policy = {0};
@@ -238,21 +577,21 @@ void MCTNode::rollout()
         // all legal moves
         auto legalMoves = game.getPossiblePlacements();
 
-        std::vector<float> probs(legalMoves.size() + 1);
+        ProbabilityList probs{};
         for (int i = 0; i < legalMoves.size(); i++)
         {
             if constexpr (USE_NEURAL_NETWORK)
-                probs[i] = policy[boardPairToInt(legalMoves[i])];
+                probs.push_back(policy[boardPairToInt<N>(legalMoves[i])]);
             else
-                probs[i] = 1.0f / (legalMoves.size() + 1);
+                probs.push_back(1.0f / (legalMoves.size() + 1));
         }
 
         // you can always pass
         legalMoves.push_back({-1, -1});
         if constexpr (USE_NEURAL_NETWORK)
-            probs[legalMoves.size() - 1] = policy[BOARD_SIZE * BOARD_SIZE];
+            probs.push_back(policy[N * N]);
         else
-            probs[legalMoves.size() - 1] = 1.0f / legalMoves.size();
+            probs.push_back(1.0f / legalMoves.size());
 
         auto [i, j] = randomAction(legalMoves, probs);
         game.move(i, j);
@@ -260,201 +599,413 @@ void MCTNode::rollout()
 
     if (game.judgeWinner() == Player::Black)
     {
-        setResult(1, 0);
+        return {1, 0};
     }
     else
     {
-        setResult(0, 1);
+        return {0, 1};
     }
-    
 }
 
-void MCTNode::setResult(int blackWinTimes, int whiteWinTimes)
+template<int N>
+typename BasicMCTNode<N>::Result BasicMCTNode<N>::evaluate()
 {
-    this->_blackWinTimes += blackWinTimes;
-    this->_whiteWinTimes += whiteWinTimes;
-    if (_parent != nullptr)
-    {
-        _parent->setResult(blackWinTimes, whiteWinTimes);
-    }
+    float value = 0.5f;
+    OutputArray policy = _engine->inference(_state, value);
+
+    // the policy of the same inference expands the node, unless a later visit has already done it
+    int expected = NOT_EXPANDED;
+    if (_expandState.compare_exchange_strong(expected, EXPANDING, std::memory_order_acq_rel))
+        createChildren(policy);
+
+    float blackWinRate = (_state.getNowPiece() == Player::Black) ? value : 1 - value;
+    return {blackWinRate, 1 - blackWinRate};
 }
 
-MCTSAI::MCTSAI(const char* onnxPath, unsigned int steps, unsigned int threadNum, bool forceSelect)
+template<int N>
+typename BasicMCTNode<N>::Result BasicMCTNode<N>::estimate(const GoGame& game)
 {
-    _engine = std::make_unique<InferenceEngine>(
-        std::make_unique<ONNXEngine>(onnxPath, threadNum));
-    MTC_STEPS = steps;
-    _forceSelect = forceSelect;
+    if (game.isGameOver())
+    {
+        if (game.judgeWinner() == Player::Black)
+            return {1, 0};
+        return {0, 1};
+    }
+    if (!USE_NEURAL_NETWORK || !USE_VALUE_HEAD || !_engine->hasValue())
+        return rollout(game);
+
+    float value = 0.5f;
+    _engine->inference(game, value);
+    float blackWinRate = (game.getNowPiece() == Player::Black) ? value : 1 - value;
+    return {blackWinRate, 1 - blackWinRate};
 }
 
-void MCTSAI::setMTCSteps(int steps)
+template<int N>
+void BasicMCTNode<N>::setResult(float blackWinTimes, float whiteWinTimes)
 {
-    MTC_STEPS = steps;
+    atomicAdd(this->_blackWinTimes, blackWinTimes);
+    atomicAdd(this->_whiteWinTimes, whiteWinTimes);
+    this->_virtualLoss--;
 }
 
-std::pair<int, int> MCTSAI::move(const GoGame& game)
+template<int N>
+int BasicMCTNode<N>::mostVisitedChild() const
 {
-    MCTNode root(game, _engine.get(), _forceSelect);
-    for (int i = 0; i < MTC_STEPS; i++)
-    {
-        root.select();
-    }
-    
-    int bestActionVistTimes = 0;
-    MCTNode* bestChild = nullptr;
+    if (!isExpanded()) return -1;
 
-    for (auto child : root._children)
+    int bestChild = -1;
+    int bestVisitTimes = 0;
+    for (int k = 0; k < _children->size; k++)
     {
-        if (child->_visitTimes > bestActionVistTimes)
+        int visitTimes = _children->visitTimes[k];
+        if (visitTimes > bestVisitTimes)
         {
-            bestActionVistTimes = child->_visitTimes;
-            bestChild = child;
+            bestVisitTimes = visitTimes;
+            bestChild = k;
         }
     }
-    return bestChild->_action;
+    return bestChild;
 }
 
-std::pair<int, int> MCTSAI::fastMove(const GoGame& game)
+template<int N>
+int BasicMCTNode<N>::bestChild() const
 {
-    MCTNode root(game, _engine.get(), _forceSelect);
-    for (int i = 0; i < MTC_STEPS / 5; i++)
-    {
-        root.select();
-    }
-    
-    int bestActionVistTimes = 0;
-    MCTNode* bestChild = nullptr;
+    if (!USE_MCTS_SOLVER || !isExpanded()) return mostVisitedChild();
 
-    for (auto child : root._children)
+    // a proven win is played at once, a proven loss only when every move loses
+    int bestChild = -1;
+    int bestVisitTimes = 0;
+    for (int k = 0; k < _children->size; k++)
     {
-        if (child->_visitTimes > bestActionVistTimes)
+        const MCTNode* node = _children->nodes[k].load(std::memory_order_acquire);
+        if (node != nullptr && node->_proof.load(std::memory_order_acquire) == ownProof()) return k;
+        if (isLostChild(k)) continue;
+
+        int visitTimes = _children->visitTimes[k];
+        if (visitTimes > bestVisitTimes)
         {
-            bestActionVistTimes = child->_visitTimes;
-            bestChild = child;
+            bestVisitTimes = visitTimes;
+            bestChild = k;
         }
     }
-    return bestChild->_action;
+    return (bestChild != -1) ? bestChild : mostVisitedChild();
 }
 
-std::tuple<std::pair<int,int>, InputArray, OutputArray> MCTSAI::recordedMove (const GoGame& game)
+template<int N>
+std::pair<int, int> BasicMCTNode<N>::bestAction() const
 {
-    MCTNode root(game, _engine.get(), _forceSelect);
-    for (int i = 0; i < MTC_STEPS; i++)
+    int bestChild = this->bestChild();
+    if (bestChild == -1) return {-1, -1};
+    return _children->actions[bestChild];
+}
+
+template<int N>
+bool BasicMCTNode<N>::isDecided(int remainingVisits) const
+{
+    if (!isExpanded()) return false;
+    // a forced move, or a solved position
+    if (_children->size == 1 || (USE_MCTS_SOLVER && isProven())) return true;
+
+    int bestVisitTimes = 0;
+    int secondVisitTimes = 0;
+    int candidateNum = 0;
+    for (int k = 0; k < _children->size; k++)
     {
-        root.select();
+        // a refuted move keeps its visits, but it is not played
+        if (USE_MCTS_SOLVER && isLostChild(k)) continue;
+        candidateNum++;
+        int visitTimes = _children->visitTimes[k];
+        if (visitTimes > bestVisitTimes)
+        {
+            secondVisitTimes = bestVisitTimes;
+            bestVisitTimes = visitTimes;
+        }
+        else if (visitTimes > secondVisitTimes)
+        {
+            secondVisitTimes = visitTimes;
+        }
     }
+    // every other move is proven to lose
+    if (candidateNum == 1 && bestVisitTimes > 0) return true;
+    return bestVisitTimes - secondVisitTimes > remainingVisits;
+}
 
-    int bestActionVistTimes = 0;
-    MCTNode* bestChild = nullptr;
+template<int N>
+SearchStats BasicMCTNode<N>::search(int steps, unsigned int threadNum, const std::function<bool()>& shouldStop, ThreadPool* pool)
+{
+    if (threadNum == 0) threadNum = std::max(1u, std::thread::hardware_concurrency());
 
-    OutputArray output = {0};
-    int sum = 0;
+    std::atomic<int> selected = 0;
+    // every thread counts its own selects, they are added up when it ends
+    SearchStats stats;
+    long long depthSum = 0;
+    std::mutex statsMutex;
+    auto worker = [&]()
+    {
+        int simulations = 0;
+        int maxDepth = 0;
+        long long threadDepthSum = 0;
+        while (selected++ < steps)
+        {
+            int depth = select();
+            simulations++;
+            maxDepth = std::max(maxDepth, depth);
+            threadDepthSum += depth;
+            if (shouldStop && shouldStop()) break;
+        }
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.simulations += simulations;
+        stats.maxDepth = std::max(stats.maxDepth, maxDepth);
+        depthSum += threadDepthSum;
+    };
 
-    for (auto child : root._children)
+    if (threadNum == 1)
+    {
+        worker();
+    }
+    // all threads descend the same tree, the virtual loss keeps them on different paths
+    else if (pool != nullptr)
+    {
+        std::vector<std::future<void>> tasks;
+        for (unsigned int i = 1; i < threadNum; i++)
+        {
+            tasks.push_back(pool->submit(worker));
+        }
+        worker();
+        for (auto& task : tasks)
+        {
+            task.get();
+        }
+    }
+    else
     {
-        sum += child->_visitTimes;
-        int index = boardPairToInt(child->_action);
-        index = index == -1 ? BOARD_SIZE * BOARD_SIZE : index;
-        output[index] = child->_visitTimes;
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadNum; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
 
-        if (child->_visitTimes > bestActionVistTimes)
+    if (stats.simulations > 0) stats.averageDepth = static_cast<double>(depthSum) / stats.simulations;
+    return stats;
+}
+
+template<int N>
+std::size_t BasicMCTNode<N>::subtreeSize() const
+{
+    std::size_t size = 0;
+    std::vector<const MCTNode*> stack = {this};
+    std::unordered_set<const MCTNode*> seen;
+    while (!stack.empty())
+    {
+        const MCTNode* node = stack.back();
+        stack.pop_back();
+        if (USE_TRANSPOSITION_TABLE && !seen.insert(node).second) continue;
+        size++;
+        if (!node->isExpanded()) continue;
+        for (int k = 0; k < node->_children->size; k++)
         {
-            bestActionVistTimes = child->_visitTimes;
-            bestChild = child;
+            const MCTNode* child = node->_children->nodes[k].load(std::memory_order_acquire);
+            if (child != nullptr) stack.push_back(child);
         }
     }
+    return size;
+}
 
-    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE + 1; i++)
+template<int N>
+BasicMCTNode<N>* BasicMCTNode<N>::copyTo(TreeArena* arena) const
+{
+    // in the DAG mode a node with several parents is copied once, the table of the new arena has its copy
+    if constexpr (USE_TRANSPOSITION_TABLE)
     {
-        output[i] = (float) output[i] / sum;
+        MCTNode* copy = arena->transpositions.find(_state.positionKey());
+        if (copy != nullptr) return copy;
     }
 
-    return {bestChild->_action, getFeatures(game), output};
+    MCTNode* node = new (arena->nodes.allocate(1)) MCTNode(_state, _engine, arena, _isForceSelect);
+    node->_visitTimes    = _visitTimes.load();
+    node->_blackWinTimes = _blackWinTimes.load();
+    node->_whiteWinTimes = _whiteWinTimes.load();
+    node->_proof         = _proof.load();
+    if constexpr (USE_TRANSPOSITION_TABLE)
+        arena->transpositions.insert(_state.positionKey(), node);
+    // a LEAF is NOT_EXPANDED in the copy, the new arena may have room for its children
+    if (!isExpanded()) return node;
+
+    Children* children = new (arena->children.allocate(1)) Children;
+    children->size = _children->size;
+    for (int k = 0; k < children->size; k++)
+    {
+        children->actions[k] = _children->actions[k];
+        children->priors[k]  = _children->priors[k];
+        children->visitTimes[k].store(_children->visitTimes[k].load(), std::memory_order_relaxed);
+        children->virtualLoss[k].store(0, std::memory_order_relaxed);
+        children->blackWinTimes[k].store(_children->blackWinTimes[k].load(), std::memory_order_relaxed);
+        children->whiteWinTimes[k].store(_children->whiteWinTimes[k].load(), std::memory_order_relaxed);
+        MCTNode* child = _children->nodes[k].load(std::memory_order_acquire);
+        children->nodes[k].store((child != nullptr) ? child->copyTo(arena) : nullptr, std::memory_order_relaxed);
+    }
+    node->_children = children;
+    node->_expandState = EXPANDED;
+    return node;
 }
 
-TimeLimitMCTSAI::TimeLimitMCTSAI(const char* onnxPath, unsigned int threadNum, int timeLimit)
+template<int N>
+BasicMCTSAI<N>::BasicMCTSAI(const char* onnxPath, unsigned int steps, unsigned int threadNum, bool forceSelect,
+                            unsigned int searchThreadNum)
+    : BasicMCTSAI(makeSearchEngine<N>(onnxPath, threadNum, searchThreadNum), steps, forceSelect, searchThreadNum)
 {
-    _engine = std::make_unique<InferenceEngine>(
-        std::make_unique<ONNXEngine>(onnxPath, threadNum));
-    _timeLimit = timeLimit;
 }
 
-std::pair<int, int> TimeLimitMCTSAI::move(const GoGame& game)
+template<int N>
+BasicMCTSAI<N>::BasicMCTSAI(std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>&& engine, unsigned int steps, bool forceSelect,
+                            unsigned int searchThreadNum)
+{
+    _engine = std::make_unique<InferenceEngine>(std::move(engine));
+    _arena = std::make_unique<TreeArena>();
+    MTC_STEPS = steps;
+    _forceSelect = forceSelect;
+    _searchThreadNum = (searchThreadNum == 0) ? std::max(1u, std::thread::hardware_concurrency()) : searchThreadNum;
+    _pool = std::make_unique<ThreadPool>(_searchThreadNum - 1);
+}
+
+template<int N>
+BasicInferenceEngine<N>& BasicMCTSAI<N>::getInferenceEngine()
 {
-    std::promise<std::pair<int, int>> promise;
-    auto future = promise.get_future();
-    std::thread(&TimeLimitMCTSAI::moveAsync, this, game, std::ref(promise)).detach();
-    return future.get();
+    return *_engine;
 }
 
-void TimeLimitMCTSAI::moveAsync(const GoGame& game, std::promise<std::pair<int, int>>& promise)
+template<int N>
+void BasicMCTSAI<N>::setMTCSteps(int steps)
 {
-    using namespace std::chrono;
+    MTC_STEPS = steps;
+}
 
-    auto startTime     = steady_clock::now();
-    auto fixedDuration = seconds(_timeLimit);
+template<int N>
+void BasicMCTSAI<N>::setMaxTreeMemory(std::size_t bytes)
+{
+    _arena = std::make_unique<TreeArena>(bytes);
+}
 
-    auto eTree         = ExhaustiveTree(game);
-    auto mustWinMove   = std::async(&ExhaustiveTree::getMustWinMove, &eTree);
-    
+template<int N>
+std::pair<int, int> BasicMCTSAI<N>::move(const GoGame& game)
+{
+    // the tree of the last search is freed at once
+    _arena->clear();
+    MCTNode root(game, _engine.get(), _arena.get(), _forceSelect);
+    root.search(MTC_STEPS, _searchThreadNum, nullptr, _pool.get());
 
-    MCTNode root(game, _engine.get(), _forceSelect);
-    for (int i = 0; i < _maxSteps; i++)
-    {
-        root.select();
-        if (steady_clock::now() - startTime > fixedDuration)
-        {
-            break;
-        }
-    }
+    return root.bestAction();
+}
 
-    // 判断是否有必胜走法
-    eTree.stop(); 
-    auto mustWinResult = mustWinMove.get();
-    if(mustWinResult.has_value())
+template<int N>
+std::pair<int, int> BasicMCTSAI<N>::fastMove(const GoGame& game)
+{
+    _arena->clear();
+    MCTNode root(game, _engine.get(), _arena.get(), _forceSelect);
+    root.search(MTC_STEPS / 5, _searchThreadNum, nullptr, _pool.get());
+
+    return root.bestAction();
+}
+
+template<int N>
+std::tuple<std::pair<int,int>, BasicInputArray<N>, BasicOutputArray<N>> BasicMCTSAI<N>::recordedMove (const GoGame& game)
+{
+    _arena->clear();
+    MCTNode root(game, _engine.get(), _arena.get(), _forceSelect);
+    root.search(MTC_STEPS, _searchThreadNum, nullptr, _pool.get());
+
+    OutputArray output = {0};
+    int sum = 0;
+
+    for (int k = 0; root.isExpanded() && k < root._children->size; k++)
     {
-        promise.set_value(mustWinResult.value());
-        return;
+        sum += root._children->visitTimes[k];
+        int index = boardPairToInt<N>(root._children->actions[k]);
+        index = index == -1 ? N * N : index;
+        output[index] = root._children->visitTimes[k];
     }
-    
-    int bestActionVistTimes = 0;
-    MCTNode* bestChild = nullptr;
 
-    for (auto child : root._children)
+    for (int i = 0; i < N * N + 1; i++)
     {
-        if (child->_visitTimes > bestActionVistTimes)
-        {
-            bestActionVistTimes = child->_visitTimes;
-            bestChild = child;
-        }
+        output[i] = (float) output[i] / sum;
     }
 
-    promise.set_value(bestChild->_action);
+    return {root.bestAction(), getFeatures(game), output};
+}
+
+template<int N>
+BasicTimeLimitMCTSAI<N>::BasicTimeLimitMCTSAI(const char* onnxPath, unsigned int threadNum, std::chrono::milliseconds timeLimit,
+                                              unsigned int searchThreadNum)
+{
+    _engine = std::make_unique<InferenceEngine>(
+        makeSearchEngine<N>(onnxPath, threadNum, searchThreadNum));
+    _arena = std::make_unique<TreeArena>(_maxTreeMemory);
+    _timeLimit = timeLimit;
+    _searchThreadNum = (searchThreadNum == 0) ? std::max(1u, std::thread::hardware_concurrency()) : searchThreadNum;
+    _pool = std::make_unique<ThreadPool>(_searchThreadNum + 1);
+}
+
+template<int N>
+std::pair<int, int> BasicTimeLimitMCTSAI<N>::move(const GoGame& game)
+{
+    auto [x, y, blackWinRate] = submitMove(game, std::chrono::steady_clock::now() + _timeLimit).get();
+    return {x, y};
+}
+
+template<int N>
+std::tuple<int, int, float> BasicTimeLimitMCTSAI<N>::evaMove(const GoGame& game)
+{
+    return submitMove(game, std::chrono::steady_clock::now() + _timeLimit).get();
+}
+
+template<int N>
+std::shared_future<std::tuple<int, int, float>> BasicTimeLimitMCTSAI<N>::submitMove(const GoGame& game, std::chrono::steady_clock::time_point deadline,
+                                                                                 CancellationToken token)
+{
+    // the tree can only be changed when nobody searches it, and two searches on the pool would starve each other
+    waitForMove();
+    stopPondering();
+    _moveTask = _pool->submit([this, game, deadline, token]() { return searchMove(game, deadline, token); }).share();
+    return _moveTask;
 }
 
-std::tuple<int, int, float> TimeLimitMCTSAI::evaMove(const GoGame& game)
+template<int N>
+std::tuple<int, int, float> BasicTimeLimitMCTSAI<N>::searchMove(const GoGame& game, std::chrono::steady_clock::time_point deadline,
+                                                                const CancellationToken& token)
 {
     using namespace std::chrono;
 
-    auto startTime     = steady_clock::now();
-    auto fixedDuration = seconds(_timeLimit);
+    auto startTime      = steady_clock::now();
+    auto inferenceCalls = _engine->getInferenceCalls();
+    auto inferenceTime  = _engine->getInferenceTime();
 
-    auto eTree         = ExhaustiveTree(game);
-    auto mustWinMove   = std::async(&ExhaustiveTree::getMustWinMove, &eTree);
+    auto eTree         = BasicExhaustiveTree<N>(game);
+    auto mustWinMove   = _pool->submit([&eTree]() { return eTree.getMustWinMove(); }).share();
 
-    MCTNode root(game, _engine.get(), _forceSelect);
-    for (int i = 0; i < _maxSteps; i++)
-    {
-        root.select();
-        if (steady_clock::now() - startTime > fixedDuration)
-        {
-            break;
-        }
-    }
+    MCTNode& root = getRoot(game);
+    SearchStats stats = timedSearch(root, deadline, token, mustWinMove);
 
     // 判断是否有必胜走法
     eTree.stop(); 
-    auto mustWinResult = mustWinMove.get();
+    auto& mustWinResult = mustWinMove.get();
+
+    stats.nMove                = game.getNMove();
+    stats.seconds              = duration<double>(steady_clock::now() - startTime).count();
+    stats.simulationsPerSecond = (stats.seconds > 0) ? stats.simulations / stats.seconds : 0;
+    stats.inferenceCalls       = _engine->getInferenceCalls() - inferenceCalls;
+    stats.inferenceSeconds     = duration<double>(_engine->getInferenceTime() - inferenceTime).count();
+    stats.nodeCount            = _arena->nodeCount();
+    stats.memoryBytes          = _arena->memoryBytes();
+    stats.exhaustiveNodes      = eTree.getNodeCount();
+    stats.exhaustiveOutcome    = outcomeName<N>(eTree.getOutcome());
+    _lastStats = stats;
+    if (!_statsPath.empty()) stats.appendJsonLine(_statsPath);
+
     if(mustWinResult.has_value())
     {
         auto [x, y] = mustWinResult.value();
@@ -470,20 +1021,208 @@ std::tuple<int, int, float> TimeLimitMCTSAI::evaMove(const GoGame& game)
         return {x,y,bwr};
     }
     
-    int bestActionVistTimes = 0;
-    MCTNode* bestChild = nullptr;
+    int bestChild = root.bestChild();
+    if (bestChild == -1) return {-1, -1, 0.5f};
+
+    const auto& children = *root._children;
+    float blackWinRate = (float) children.blackWinTimes[bestChild] / children.visitTimes[bestChild];
+    // the win rate of a proven move is exact
+    const MCTNode* node = children.nodes[bestChild].load(std::memory_order_acquire);
+    if (node != nullptr && node->isProven())
+        blackWinRate = (node->_proof == MCTNode::BLACK_WINS) ? 1 : 0;
+    auto [x,y] = children.actions[bestChild];
+    return {x, y, blackWinRate};
+}
+
+template<int N>
+const SearchStats& BasicTimeLimitMCTSAI<N>::getLastSearchStats() const
+{
+    return _lastStats;
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::setStatsPath(const std::string& path)
+{
+    _statsPath = path;
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::setMaxTreeMemory(std::size_t bytes)
+{
+    waitForMove();
+    stopPondering();
+    _root = nullptr;
+    _maxTreeMemory = bytes;
+    _arena = std::make_unique<TreeArena>(bytes);
+}
+
+template<int N>
+BasicInferenceEngine<N>& BasicTimeLimitMCTSAI<N>::getInferenceEngine()
+{
+    return *_engine;
+}
+
+template<int N>
+BasicTimeLimitMCTSAI<N>::~BasicTimeLimitMCTSAI()
+{
+    stopPondering();
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::startPondering(const GoGame& game)
+{
+    waitForMove();
+    stopPondering();
+    if (game.isGameOver()) return;
 
-    for (auto child : root._children)
+    MCTNode& root = getRoot(game);
+    _ponderToken = CancellationToken();
+    _ponderTask = _pool->submit([this, &root, token = _ponderToken]()
     {
-        if (child->_visitTimes > bestActionVistTimes)
+        root.search(_maxSteps, _searchThreadNum, [&token]() { return token.isCancelled(); }, _pool.get());
+    });
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::stopPondering()
+{
+    if (!_ponderTask.valid()) return;
+    _ponderToken.cancel();
+    _ponderTask.get();
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::waitForMove()
+{
+    // the result or the exception is left to the owner of the future
+    if (_moveTask.valid()) _moveTask.wait();
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::play(std::pair<int, int> action)
+{
+    // the tree can only be changed when nobody searches it
+    waitForMove();
+    stopPondering();
+    if (_root == nullptr) return;
+    if (_root->isExpanded())
+    {
+        const auto& children = *_root->_children;
+        for (int k = 0; k < children.size; k++)
         {
-            bestActionVistTimes = child->_visitTimes;
-            bestChild = child;
+            MCTNode* child = children.nodes[k].load(std::memory_order_acquire);
+            if (children.actions[k] == action && child != nullptr)
+            {
+                promote(child);
+                return;
+            }
         }
     }
+    // the move is not in the tree, the next search starts a fresh one
+    _root = nullptr;
+}
 
-    float blackWinRate = (float) bestChild->_blackWinTimes / bestChild->_visitTimes;
-    auto [x,y] = bestChild->_action;
-    return {x, y, blackWinRate};
+template<int N>
+BasicMCTNode<N>& BasicTimeLimitMCTSAI<N>::getRoot(const GoGame& game)
+{
+    stopPondering();
+    if (_root != nullptr)
+    {
+        // the game may have gone on by some moves which are not told by play, look for it two plies down
+        std::vector<MCTNode*> candidates = {_root};
+        for (int depth = 0; depth <= 2 && !candidates.empty(); depth++)
+        {
+            std::vector<MCTNode*> next;
+            for (auto node : candidates)
+            {
+                if (samePosition(node->_state, game))
+                {
+                    if (node != _root) promote(node);
+                    return *_root;
+                }
+                if (node->isExpanded())
+                {
+                    // the children without a node have never been visited, there is nothing to reuse
+                    const auto& children = *node->_children;
+                    for (int k = 0; k < children.size; k++)
+                    {
+                        MCTNode* child = children.nodes[k].load(std::memory_order_acquire);
+                        if (child != nullptr) next.push_back(child);
+                    }
+                }
+            }
+            candidates = std::move(next);
+        }
+    }
+
+    // a fresh tree, the old one is freed at once
+    _arena->clear();
+    _root = new (_arena->nodes.allocate(1)) MCTNode(game, _engine.get(), _arena.get(), _forceSelect);
+    return *_root;
+}
+
+template<int N>
+SearchStats BasicTimeLimitMCTSAI<N>::timedSearch(MCTNode& root, std::chrono::steady_clock::time_point deadline, const CancellationToken& token,
+                                          const std::shared_future<std::optional<std::pair<int, int>>>& mustWinMove)
+{
+    using namespace std::chrono;
+
+    // the tree may be reused, only the visits of this search tell its speed
+    auto startTime = steady_clock::now();
+    int startVisitTimes = root._visitTimes;
+    return root.search(_maxSteps, _searchThreadNum, [&]()
+    {
+        auto now = steady_clock::now();
+        if (now > deadline || token.isCancelled()) return true;
+        if (!USE_EARLY_STOP) return false;
+
+        // the root is solved
+        if (mustWinMove.wait_for(seconds(0)) == std::future_status::ready && mustWinMove.get().has_value())
+            return true;
+
+        // the visits of the rest of the time at the speed so far, until the speed is known any lead can be caught
+        int visitTimes = root._visitTimes - startVisitTimes;
+        double remainingVisits = std::numeric_limits<int>::max();
+        if (visitTimes >= EARLY_STOP_MIN_VISITS)
+            remainingVisits = visitTimes * duration<double>(deadline - now).count() / duration<double>(now - startTime).count();
+        return root.isDecided(std::min<double>(remainingVisits, std::numeric_limits<int>::max()));
+    }, _pool.get());
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::promote(MCTNode* node)
+{
+    node->_isForceSelect = _forceSelect;
+    _root = node;
+
+    // the nodes out of the subtree are only freed with the arena, a full one would leave no room to grow.
+    // Copying pays when the subtree is small, then the fresh arena is not full again at the next move
+    if (_arena->fill() > TREE_RECYCLE_FILL &&
+        _root->subtreeSize() <= TREE_RECYCLE_FILL * _arena->nodes.capacity())
+        recycle();
+}
+
+template<int N>
+void BasicTimeLimitMCTSAI<N>::recycle()
+{
+    // the subtree fits in the new arena as it fits in the old one of the same budget
+    auto arena = std::make_unique<TreeArena>(_maxTreeMemory);
+    _root = _root->copyTo(arena.get());
+    _arena = std::move(arena);
 }
 
+template std::unique_ptr<BasicNeuralNetworkInferenceEngine<5>> makeSearchEngine<5>(const char*, unsigned int, unsigned int);
+template std::unique_ptr<BasicNeuralNetworkInferenceEngine<7>> makeSearchEngine<7>(const char*, unsigned int, unsigned int);
+template std::unique_ptr<BasicNeuralNetworkInferenceEngine<9>> makeSearchEngine<9>(const char*, unsigned int, unsigned int);
+template class BasicInferenceEngine<5>;
+template class BasicInferenceEngine<7>;
+template class BasicInferenceEngine<9>;
+template class BasicMCTNode<5>;
+template class BasicMCTNode<7>;
+template class BasicMCTNode<9>;
+template class BasicMCTSAI<5>;
+template class BasicMCTSAI<7>;
+template class BasicMCTSAI<9>;
+template class BasicTimeLimitMCTSAI<5>;
+template class BasicTimeLimitMCTSAI<7>;
+template class BasicTimeLimitMCTSAI<9>;
@@ -1,90 +1,461 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <future>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <thread>
 
 #include "AI.h"
 #include "../Model/ONNXEngine.h"
+#include "../Model/BatchInferenceEngine.hpp"
 #include "../utils/FIFOCache.hpp"
+#include "../utils/FixedVector.hpp"
+#include "../utils/Arena.hpp"
+#include "../utils/TranspositionTable.hpp"
+#include "../utils/ThreadPool.hpp"
+#include "EvaluationCache.hpp"
+#include "SearchStats.h"
 
-class InferenceEngine
+// The probabilities of the moves in a MoveList.
+template<int N>
+using BasicProbabilityList = FixedVector<float, N * N + 1>;
+typedef BasicProbabilityList<BOARD_SIZE> ProbabilityList;
+
+/**
+ * @brief Create the ONNX engine of a search, the evaluations of several search threads are batched.
+ * @param onnxPath: the path of the onnx file.
+ * @param threadNum: the number of inference threads.
+ * @param searchThreadNum: the number of search threads, 0 for all cores.
+ * @return std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>: the engine.
+ */
+template<int N>
+std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>> makeSearchEngine(const char* onnxPath, unsigned int threadNum, unsigned int searchThreadNum);
+
+// The classes below are templates on the board size N, MCTSAI, ... are the classes of BOARD_SIZE.
+template<int N> class BasicMCTSAI;
+template<int N> class BasicTimeLimitMCTSAI;
+template<int N> class BasicMCTNode;
+template<int N> struct BasicTreeArena;
+
+template<int N>
+class BasicInferenceEngine
 {
     private:        
-        std::unique_ptr<NeuralNetworkInferenceEngine> _engine;
+        std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>> _engine;
+        std::unique_ptr<BasicEvaluationCache<N>> _cache;
+        // the evaluations of the network and the time in it, the cache hits are not counted
+        std::atomic<std::size_t> _inferenceCalls{0};
+        std::atomic<long long>   _inferenceNanoseconds{0};
     public:
-        InferenceEngine(std::unique_ptr<NeuralNetworkInferenceEngine>&& engine);
-        OutputArray inference(const GoGame& game);
+        /**
+         * @brief Constructs an InferenceEngine, the evaluations are cached in front of the engine.
+         * @param engine: the engine of the network.
+         * @param cacheSize: the number of positions in the cache, 0 for no cache.
+         */
+        BasicInferenceEngine(std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>&& engine, std::size_t cacheSize = MAX_CACHE_SIZE);
+        BasicOutputArray<N> inference(const BasicGoGame<N>& game);
+
+        /**
+         * @brief Get the policy and the value of a position.
+         * @param game: the position.
+         * @param value: set to the win rate of the player to move, unchanged if the model has no value output.
+         * @return BasicOutputArray<N>: the policy.
+         */
+        BasicOutputArray<N> inference(const BasicGoGame<N>& game, float& value);
+
+        bool hasValue() const;
+
+        /**
+         * @brief Make a new empty cache, it can not be called during a search.
+         * @param cacheSize: the number of positions in the cache, 0 for no cache.
+         */
+        void setCacheSize(std::size_t cacheSize);
+
+        /**
+         * @brief Get the cache, for its counters.
+         * @return BasicEvaluationCache<N>*: the cache, nullptr if there is no cache.
+         */
+        BasicEvaluationCache<N>* getCache();
+
+        std::size_t getInferenceCalls() const;
+        std::chrono::nanoseconds getInferenceTime() const;
+};
+
+// The children of an expanded node, as arrays of their statistics, so the selection reads every child in one pass.
+// Child k is the move actions[k], its node is only made when the search first descends into it.
+// With USE_PROGRESSIVE_WIDENING the children are in the descending order of their priors.
+template<int N>
+struct BasicMCTChildren
+{
+    static constexpr int CAPACITY = N * N + 1;
+
+    int                                                 size;
+    std::array<std::pair<int, int>, CAPACITY>           actions;
+    std::array<float, CAPACITY>                         priors;
+    // the counters of the edges are shared by the search threads
+    std::array<std::atomic<int>, CAPACITY>              visitTimes;
+    // the visits which are still running below the edge, see BasicMCTNode::_virtualLoss
+    std::array<std::atomic<int>, CAPACITY>              virtualLoss;
+    std::array<std::atomic<float>, CAPACITY>            blackWinTimes;
+    std::array<std::atomic<float>, CAPACITY>            whiteWinTimes;
+    std::array<std::atomic<BasicMCTNode<N>*>, CAPACITY> nodes;
 };
 
-class MCTNode
+template<int N>
+class BasicMCTNode
 {
-    friend class MCTSAI;
-    friend class TimeLimitMCTSAI;
+    friend class BasicMCTSAI<N>;
+    friend class BasicTimeLimitMCTSAI<N>;
     private:
-        MCTNode* _parent;
-        std::vector<MCTNode*> _children;
-        GoGame _state;
-        std::pair<int, int> _action;
+        typedef BasicGoGame<N>            GoGame;
+        typedef BasicMoveList<N>          MoveList;
+        typedef BasicProbabilityList<N>   ProbabilityList;
+        typedef BasicOutputArray<N>       OutputArray;
+        typedef BasicInferenceEngine<N>   InferenceEngine;
+        typedef BasicMCTNode<N>           MCTNode;
+        typedef BasicMCTChildren<N>       Children;
+        typedef BasicTreeArena<N>         TreeArena;
+        // The wins of black and white of a visit.
+        typedef std::pair<float, float>   Result;
 
-        float _P;
-        int _visitTimes;
-        int _blackWinTimes;
-        int _whiteWinTimes;
+        // The states of the expansion of a node, _children can only be read when it is EXPANDED.
+        // A LEAF has found the arena full, it is not expanded in this tree.
+        enum ExpandState : int { NOT_EXPANDED = 0, EXPANDING = 1, EXPANDED = 2, LEAF = 3 };
+        // The result of a solved position in the MCTS-solver, whoever moves.
+        enum Proof : int { UNPROVEN = 0, BLACK_WINS = 1, WHITE_WINS = 2 };
+        // added to the PUCT of a move which is proven to lose
+        static constexpr float LOST_MOVE_PENALTY = -1.0e9f;
+
+        GoGame _state;
+        Children* _children;
+        // the counters of the position, in the DAG mode they have the visits of all parents
+        std::atomic<int> _visitTimes;
+        // the wins are fractional when the value of the model is backed up
+        std::atomic<float> _blackWinTimes;
+        std::atomic<float> _whiteWinTimes;
+        // the visits which are still running below the node, each counts as VIRTUAL_LOSS losses until its result comes back,
+        // one of them is its visit in _visitTimes
+        std::atomic<int> _virtualLoss;
+        std::atomic<int> _expandState;
+        // the Proof of the position, it only changes from UNPROVEN once
+        std::atomic<int> _proof;
 
         InferenceEngine* _engine;
+        TreeArena* _arena;
         bool _isForceSelect;
 
-        MCTNode* selectBestChild();
-        std::pair<int, int> randomAction(const std::vector<std::pair<int, int>>& actions,
-                                         const std::vector<float>& probs);
+        // get the index of the child with the best PUCT
+        int selectBestChild() const;
+        // get the node of a child, it is made on the first call, in the DAG mode it may be the node of another parent.
+        // It is nullptr if the arena is full
+        MCTNode* child(int k);
+        std::pair<int, int> randomAction(const MoveList& actions,
+                                         const ProbabilityList& probs);
+        // create the children with the policy, the node must be claimed by EXPANDING, it becomes a LEAF if the arena is full
+        bool createChildren(const OutputArray& policy);
+        // the result of a position without a node, the end of the game, the value of the model or a rollout
+        Result estimate(const GoGame& game);
+        Result rollout(GoGame game);
+
+        // the Proof of a new node of the game, only the end of the game is proven
+        static int proofOf(const GoGame& game);
+        // the Proof of a win of the player to move, and of the opponent
+        int ownProof() const;
+        int opponentProof() const;
+        // try to prove the node after child k is proven, it returns whether the node is newly proven
+        bool prove(int k);
     
     public:
-        // This constructor is used for root node
-        MCTNode(const GoGame& game, InferenceEngine* engine, bool forceSelect);
+        // This constructor is used for root node, the nodes of the tree are taken from the arena
+        BasicMCTNode(const GoGame& game, InferenceEngine* engine, TreeArena* arena, bool forceSelect);
 
-        // This constructor is used for other nodes
-        MCTNode(MCTNode* parent, std::pair<int, int> action, InferenceEngine* engine, float P);
+        // This constructor is used for other nodes, the position is the one after the action
+        BasicMCTNode(const GoGame& parentState, std::pair<int, int> action, InferenceEngine* engine, TreeArena* arena);
 
-        ~MCTNode();
+        bool isExpanded() const;
+        
+        // expand the node, it returns false if the node stays a LEAF
+        bool expand();
+        // one visit from this node down to a leaf, and back up along the same path, it returns the depth of the leaf
+        int select();
+        Result rollout();
+        // evaluate a leaf with the value of the model, it is expanded with the policy of the same inference
+        Result evaluate();
+        void setResult(float blackWinTimes, float whiteWinTimes);
 
-        float getPUCT() const;
+        // the children of the node, 0 if it is not expanded
+        int getChildNum() const;
+        int getChildVisitTimes(int k) const;
 
-        bool isRoot() const;
-        
-        void expand();
-        void select();
-        void rollout();
-        void setResult(int blackWinTimes, int whiteWinTimes);
+        // whether the position is solved by the MCTS-solver, and whether the player to move wins it
+        bool isProven() const;
+        bool isWon() const;
+
+        /**
+         * @brief Check whether a child is proven to lose for the player to move, it is not played, see bestChild.
+         * @param k: the index of the child.
+         * @return bool: whether the node of the child is proven to be won by the opponent.
+         */
+        bool isLostChild(int k) const;
+
+        /**
+         * @brief Get the child with the most visits.
+         * @return int: the index of the child, -1 if no child is visited.
+         */
+        int mostVisitedChild() const;
+
+        /**
+         * @brief Get the child to play, a proven win, else the most visited child which is not proven to lose.
+         * @return int: the index of the child, -1 if no child is visited.
+         */
+        int bestChild() const;
+
+        /**
+         * @brief Get the move of the child to play, see bestChild.
+         * @return std::pair<int, int>: the move, {-1, -1} (pass) if no child is visited.
+         */
+        std::pair<int, int> bestAction() const;
+
+        /**
+         * @brief Check whether the most visited child stays the most visited, so a search can stop early.
+         *        The children proven to lose are not counted, as bestChild does not play them.
+         * @param remainingVisits: the visits which the search is expected to make from now on.
+         * @return bool: whether it is the only child, or the runner-up can not catch it even with all the remaining visits.
+         */
+        bool isDecided(int remainingVisits) const;
+
+        /**
+         * @brief Run select on the root with some threads, a tree-parallel search.
+         * @param steps: the maximum number of selects of all threads.
+         * @param threadNum: the number of search threads, 1 runs the search in the calling thread.
+         * @param shouldStop: a function called before every select, the search stops if it returns true.
+         * @param pool: the pool which runs the other threadNum - 1 threads, nullptr to start new threads.
+         *              It needs that many free threads, the calling thread is one of the search threads.
+         * @return SearchStats: the simulations and the depths of the search, the other stats are not filled.
+         */
+        SearchStats search(int steps, unsigned int threadNum, const std::function<bool()>& shouldStop = nullptr, ThreadPool* pool = nullptr);
+
+        /**
+         * @brief Copy the subtree of the node to another arena, no search may run on it.
+         * @param arena: the arena of the copy, it must have room for the subtree.
+         * @return MCTNode*: the copy of the node, its LEAFs can be expanded again.
+         */
+        MCTNode* copyTo(TreeArena* arena) const;
 
+        /**
+         * @brief Count the nodes of the subtree of the node, a node with several parents in the DAG mode once.
+         * @return std::size_t: the nodes, the node itself included.
+         */
+        std::size_t subtreeSize() const;
 };
 
-class MCTSAI : public AI
+// The memory of the nodes and of the children of a search tree, and the nodes of the positions in the DAG mode,
+// they are freed together. It is the node pool of the tree: a node has at most one children block,
+// so it holds as many of both as fit in maxMemory, and the tree stops growing when it is full.
+template<int N>
+struct BasicTreeArena
+{
+    Arena<BasicMCTNode<N>>              nodes;
+    Arena<BasicMCTChildren<N>>          children;
+    TranspositionTable<BasicMCTNode<N>> transpositions{};
+
+    explicit BasicTreeArena(std::size_t maxMemory = MAX_TREE_MEMORY)
+        : nodes(NODE_ARENA_CHUNK_SIZE, capacityOf(maxMemory)), children(NODE_ARENA_CHUNK_SIZE, capacityOf(maxMemory))
+    {
+    }
+
+    // the nodes with their children which fit in the memory, at least the root
+    static std::size_t capacityOf(std::size_t maxMemory)
+    {
+        return std::max<std::size_t>(maxMemory / (sizeof(BasicMCTNode<N>) + sizeof(BasicMCTChildren<N>)), 1);
+    }
+
+    void clear()
+    {
+        nodes.clear();
+        children.clear();
+        transpositions.clear();
+    }
+
+    std::size_t nodeCount()   { return nodes.size(); }
+    std::size_t memoryBytes() { return nodes.memoryBytes() + children.memoryBytes(); }
+    // the part of the capacity which is used
+    double fill()             { return static_cast<double>(nodes.size()) / nodes.capacity(); }
+};
+
+template<int N>
+class BasicMCTSAI : public BasicAI<N>
 {
     private:
+        typedef BasicGoGame<N>            GoGame;
+        typedef BasicInputArray<N>        InputArray;
+        typedef BasicOutputArray<N>       OutputArray;
+        typedef BasicInferenceEngine<N>   InferenceEngine;
+        typedef BasicMCTNode<N>           MCTNode;
+        typedef BasicTreeArena<N>         TreeArena;
+
         std::unique_ptr<InferenceEngine> _engine;
+        // the tree of a search, the memory is reused by the next search
+        std::unique_ptr<TreeArena> _arena;
         int MTC_STEPS;
         bool _forceSelect;
+        unsigned int _searchThreadNum;
+        // the threads which search with the calling thread, they are kept for all moves
+        std::unique_ptr<ThreadPool> _pool;
 
     public:
-        MCTSAI(const char* onnxPath, unsigned int steps = DEFAULT_ITERATION, unsigned int threadNum = DEFAULT_NUM_OF_INFERENCE_THREAD, bool forceSelect = false);
+        BasicMCTSAI(const char* onnxPath, unsigned int steps = DEFAULT_ITERATION, unsigned int threadNum = DEFAULT_NUM_OF_INFERENCE_THREAD, bool forceSelect = false,
+                    unsigned int searchThreadNum = DEFAULT_NUM_OF_SEARCH_THREAD);
+        BasicMCTSAI(std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>&& engine, unsigned int steps = DEFAULT_ITERATION, bool forceSelect = false,
+                    unsigned int searchThreadNum = DEFAULT_NUM_OF_SEARCH_THREAD);
         void setMTCSteps(int steps);
+        /**
+         * @brief Set the memory budget of the search tree, see BasicTreeArena.
+         * @param bytes: the bytes of the nodes and their children.
+         */
+        void setMaxTreeMemory(std::size_t bytes);
+        InferenceEngine& getInferenceEngine();
         std::pair<int, int> move(const GoGame& game) override;
         std::pair<int, int> fastMove(const GoGame& game);
         std::tuple<std::pair<int,int>, InputArray, OutputArray> recordedMove (const GoGame& game);
 };
 
 // just for race
-class TimeLimitMCTSAI : public AI
+template<int N>
+class BasicTimeLimitMCTSAI : public BasicAI<N>
 {
     private:
+        typedef BasicGoGame<N>            GoGame;
+        typedef BasicInferenceEngine<N>   InferenceEngine;
+        typedef BasicMCTNode<N>           MCTNode;
+        typedef BasicTreeArena<N>         TreeArena;
+
         std::unique_ptr<InferenceEngine> _engine;
-        int _timeLimit;
+        // the tree of the searches of a game, a fresh tree frees it
+        std::unique_ptr<TreeArena> _arena;
+        std::size_t _maxTreeMemory = MAX_TREE_MEMORY;
+        // the root of the last search, its subtree is reused if the game has gone on from it
+        MCTNode* _root = nullptr;
+        // the search on the opponent's time, and the token which stops it
+        std::future<void> _ponderTask;
+        CancellationToken _ponderToken;
+        // the search of the last submitMove, the tree and the threads are used by one search at a time
+        std::shared_future<std::tuple<int, int, float>> _moveTask;
+        std::chrono::milliseconds _timeLimit;
+        unsigned int _searchThreadNum;
+        // the stats of the last move search, and the JSON lines file they are appended to, empty for none
+        SearchStats _lastStats;
+        std::string _statsPath;
         static const bool _forceSelect = true;
         static const int  _maxSteps    = 1000000;
+        // the threads of the searches, a move or a ponder, its other search threads and the exhaustive search,
+        // it is the last member so its tasks end before the rest of the AI is destroyed
+        std::unique_ptr<ThreadPool> _pool;
 
     public:
-        TimeLimitMCTSAI(const char* onnxPath, unsigned int threadNum, int timeLimit = 1);
+        BasicTimeLimitMCTSAI(const char* onnxPath, unsigned int threadNum, std::chrono::milliseconds timeLimit = std::chrono::seconds(1),
+                             unsigned int searchThreadNum = DEFAULT_NUM_OF_SEARCH_THREAD);
+        ~BasicTimeLimitMCTSAI() override;
         std::pair<int, int> move(const GoGame& game) override;
-        void moveAsync(const GoGame& game, std::promise<std::pair<int, int>>& promise);
+        InferenceEngine& getInferenceEngine();
         std::tuple<int, int, float> evaMove(const GoGame& game); 
-};
\ No newline at end of file
+
+        /**
+         * @brief Search a move on the threads of the AI, the AI searches one move at a time,
+         *        a new move waits for the search of the last one to end.
+         * @param game: the game.
+         * @param deadline: the search stops at this time, or earlier if the move is decided.
+         * @param token: the search stops when it is cancelled, the best move so far is the result.
+         * @return std::shared_future<std::tuple<int, int, float>>: the move and the black win rate.
+         */
+        std::shared_future<std::tuple<int, int, float>> submitMove(const GoGame& game, std::chrono::steady_clock::time_point deadline,
+                                                            CancellationToken token = {});
+
+        /**
+         * @brief Get the stats of the last move search, it can not be called during a search.
+         * @return const SearchStats&: the stats.
+         */
+        const SearchStats& getLastSearchStats() const;
+
+        /**
+         * @brief Append the stats of every move search to a JSON lines file.
+         * @param path: the path of the file, empty to stop writing.
+         */
+        void setStatsPath(const std::string& path);
+
+        /**
+         * @brief Set the memory budget of the search tree, see BasicTreeArena, the tree is searched again from scratch.
+         * @param bytes: the bytes of the nodes and their children.
+         */
+        void setMaxTreeMemory(std::size_t bytes);
+
+        /**
+         * @brief Tell the AI a move which is played, by itself or by the opponent, the subtree of the move is kept for the next search.
+         * @param action: the move, {-1, -1} for pass.
+         */
+        void play(std::pair<int, int> action);
+
+        /**
+         * @brief Search the game on a background thread until stopPondering, the tree is kept for the next search.
+         * @param game: the game, usually after the move of the AI, when the opponent is thinking.
+         */
+        void startPondering(const GoGame& game);
+
+        /**
+         * @brief Stop the search of startPondering and wait for it, nothing happens if it is not pondering.
+         */
+        void stopPondering();
+
+    private:
+        /**
+         * @brief Wait for the search of the last submitMove, nothing happens if there is none.
+         */
+        void waitForMove();
+
+        /**
+         * @brief Get the root of a search of the game, the node of the game in the last tree, or a fresh tree.
+         * @param game: the game to search.
+         * @return MCTNode&: the root.
+         */
+        MCTNode& getRoot(const GoGame& game);
+
+        /**
+         * @brief Search a move, the task of submitMove.
+         * @return std::tuple<int, int, float>: the move and the black win rate.
+         */
+        std::tuple<int, int, float> searchMove(const GoGame& game, std::chrono::steady_clock::time_point deadline,
+                                               const CancellationToken& token);
+
+        /**
+         * @brief Search until the deadline or the cancellation, or until the best move is decided, see MCTNode::isDecided,
+         *        or until the exhaustive search has found a winning move.
+         * @param root: the root of the search.
+         * @param deadline: the time the search must stop.
+         * @param token: the token of the move.
+         * @param mustWinMove: the result of the exhaustive search.
+         * @return SearchStats: the stats of MCTNode::search.
+         */
+        SearchStats timedSearch(MCTNode& root, std::chrono::steady_clock::time_point deadline, const CancellationToken& token,
+                                const std::shared_future<std::optional<std::pair<int, int>>>& mustWinMove);
+
+        /**
+         * @brief Make a node of the tree the root, the rest of the tree is not searched any more.
+         *        If the arena is full of the rest, the subtree of the node is recycled.
+         * @param node: the new root.
+         */
+        void promote(MCTNode* node);
+
+        /**
+         * @brief Copy the subtree of the root to a fresh arena and free the old one, with the nodes above and beside the root.
+         */
+        void recycle();
+};
+
+typedef BasicInferenceEngine<BOARD_SIZE> InferenceEngine;
+typedef BasicMCTNode<BOARD_SIZE>         MCTNode;
+typedef BasicMCTSAI<BOARD_SIZE>          MCTSAI;
+typedef BasicTimeLimitMCTSAI<BOARD_SIZE> TimeLimitMCTSAI;
@@ -1,6 +1,7 @@
 #include "RandomAI.h"
 
-std::pair<int, int> RandomAI::move(const GoGame& game){
+template<int N>
+std::pair<int, int> BasicRandomAI<N>::move(const BasicGoGame<N>& game){
     auto possiblePlacements = game.getPossiblePlacements();
     if (possiblePlacements.size() == 0) {
         return {-1, -1};
@@ -12,4 +13,8 @@ std::pair<int, int> RandomAI::move(const GoGame& game){
         std::uniform_int_distribution<> distribution(0, possiblePlacements.size() - 1);
         return possiblePlacements[distribution(gen)];
     }
-}
\ No newline at end of file
+}
+
+template class BasicRandomAI<5>;
+template class BasicRandomAI<7>;
+template class BasicRandomAI<9>;
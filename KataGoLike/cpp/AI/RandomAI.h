@@ -3,7 +3,10 @@
 #include "AI.h"
 #include <random>
 
-class RandomAI : public AI
+template<int N>
+class BasicRandomAI : public BasicAI<N>
 {
-    std::pair<int, int> move(const GoGame& game) override;
-};
\ No newline at end of file
+    std::pair<int, int> move(const BasicGoGame<N>& game) override;
+};
+
+typedef BasicRandomAI<BOARD_SIZE> RandomAI;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief What a search of a move did, for capacity planning and for finding regressions.
+ *
+ * MCTNode::search fills the simulations and the depths, the AI fills the rest.
+ */
+struct SearchStats
+{
+    int         nMove                = 0;     // the move number of the searched position
+    int         simulations          = 0;     // the selects of the search
+    double      seconds              = 0;     // the time of the search
+    double      simulationsPerSecond = 0;
+    std::size_t inferenceCalls       = 0;     // the positions evaluated by the network, the cache hits are not counted
+    double      inferenceSeconds     = 0;     // the time waiting for the network with its batching, summed over the search threads
+    int         maxDepth             = 0;     // the plies from the root to the deepest leaf of a select
+    double      averageDepth         = 0;
+    std::size_t nodeCount            = 0;     // the nodes in the arena, with the ones of a reused tree which are cut off
+    std::size_t memoryBytes          = 0;     // the memory of the nodes and the children in the arena
+    int         exhaustiveNodes      = 0;     // the nodes of the ExhaustiveTree
+    std::string exhaustiveOutcome    = "";    // not_run, win, no_win or stopped
+
+    /**
+     * @brief Write the stats as one line of JSON.
+     * @return std::string: the JSON object, without a newline.
+     */
+    std::string toJson() const
+    {
+        std::ostringstream out;
+        out << "{\"nMove\":" << nMove
+            << ",\"simulations\":" << simulations
+            << ",\"seconds\":" << seconds
+            << ",\"simulationsPerSecond\":" << simulationsPerSecond
+            << ",\"inferenceCalls\":" << inferenceCalls
+            << ",\"inferenceSeconds\":" << inferenceSeconds
+            << ",\"maxDepth\":" << maxDepth
+            << ",\"averageDepth\":" << averageDepth
+            << ",\"nodeCount\":" << nodeCount
+            << ",\"memoryBytes\":" << memoryBytes
+            << ",\"exhaustiveNodes\":" << exhaustiveNodes
+            << ",\"exhaustiveOutcome\":\"" << exhaustiveOutcome << "\"}";
+        return out.str();
+    }
+
+    /**
+     * @brief Append the stats to a JSON lines file.
+     * @param path: the path of the file, it is created if it does not exist.
+     * @return bool: whether the line is written.
+     */
+    bool appendJsonLine(const std::string& path) const
+    {
+        std::ofstream file(path, std::ios::app);
+        if (!file) return false;
+        file << toJson() << '\n';
+        return static_cast<bool>(file);
+    }
+};
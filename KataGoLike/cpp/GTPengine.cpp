@@ -1,6 +1,12 @@
 #include<iostream>
 #include<memory>
 #include<iomanip>
+#include<set>
+#include<algorithm>
+#include<sstream>
+#include<tuple>
+#include<charconv>
+#include<system_error>
 
 #include "GoGame/GoGame.h"
 #include "AI/RandomAI.h"
@@ -48,6 +54,126 @@ void errorOutput(int id, const std::string& output)
     std::cout << " " << output << "\n\n";
 }
 
+/**
+ * @brief Get the path of the model for a board size.
+ * @param size: the board size.
+ * @return std::string: the path of the onnx file.
+ */
+std::string modelPath(int size)
+{
+    if (size == BOARD_SIZE) return "/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx";
+    return "/home/xuyisen/project/Go_game/KataGoLike/python/model9_" + std::to_string(size) + "x" + std::to_string(size) + ".onnx";
+}
+
+/**
+ * @brief Convert a row index into a GTP letter, the letter I is skipped.
+ * @param i: the row index.
+ * @return char: the letter.
+ */
+char gtpLetter(int i)
+{
+    return (i < 8) ? ('A' + i) : ('A' + i + 1);
+}
+
+/**
+ * @brief Convert a GTP letter into a row index, the letter I is skipped.
+ * @param c: the letter, upper or lower case.
+ * @return int: the row index, -1 for the letter I.
+ */
+int gtpLetterIndex(char c)
+{
+    c = std::toupper(c);
+    if (c == 'I') return -1;
+    return (c < 'I') ? (c - 'A') : (c - 'A' - 1);
+}
+
+/**
+ * @brief The game and the AI of the GTP engine, the board size is chosen at runtime.
+ */
+class GTPGame
+{
+public:
+    virtual int    getSize() const = 0;
+    virtual Player getNowPiece() const = 0;
+    virtual bool   move(int i, int j) = 0;
+    virtual bool   isGameOver() const = 0;
+    virtual int    getNMove() const = 0;
+    virtual Player judgeWinner() const = 0;
+    virtual void   clear() = 0;
+    virtual std::tuple<int, int, float> evaMove() = 0;
+    virtual void   setCacheSize(std::size_t cacheSize) = 0;
+    virtual std::string cacheStats() = 0;
+    virtual void   startPondering() = 0;
+    virtual void   stopPondering() = 0;
+    virtual std::string searchStats() = 0;
+    virtual void   setStatsPath(const std::string& path) = 0;
+    virtual void   setMaxTreeMemory(std::size_t bytes) = 0;
+    virtual ~GTPGame() = default;
+};
+
+/**
+ * @brief The GTPGame of a board size known at compile time.
+ */
+template<int N>
+class SizedGTPGame : public GTPGame
+{
+private:
+    BasicGoGame<N> _game{};
+    BasicTimeLimitMCTSAI<N> _ai;
+
+public:
+    SizedGTPGame() : _ai(modelPath(N).c_str(), 2, std::chrono::seconds(10)) {}
+
+    int    getSize() const override                { return N; }
+    Player getNowPiece() const override            { return _game.getNowPiece(); }
+    bool   move(int i, int j) override
+    {
+        if (!_game.move(i, j)) return false;
+        // the AI keeps the subtree of the move for its next search
+        _ai.play({i, j});
+        return true;
+    }
+    bool   isGameOver() const override             { return _game.isGameOver(); }
+    int    getNMove() const override               { return _game.getNMove(); }
+    Player judgeWinner() const override            { return _game.judgeWinner(); }
+    void   clear() override                        { _game = BasicGoGame<N>(); }
+    std::tuple<int, int, float> evaMove() override { return _ai.evaMove(_game); }
+    void   setCacheSize(std::size_t cacheSize) override { _ai.getInferenceEngine().setCacheSize(cacheSize); }
+    void   startPondering() override                    { _ai.startPondering(_game); }
+    void   stopPondering() override                     { _ai.stopPondering(); }
+    std::string searchStats() override                  { return _ai.getLastSearchStats().toJson(); }
+    void   setStatsPath(const std::string& path) override { _ai.setStatsPath(path); }
+    void   setMaxTreeMemory(std::size_t bytes) override  { _ai.setMaxTreeMemory(bytes); }
+
+    std::string cacheStats() override
+    {
+        auto cache = _ai.getInferenceEngine().getCache();
+        if (cache == nullptr) return "no cache";
+        std::ostringstream stats;
+        stats << "size " << cache->size() << "/" << cache->maxSize()
+              << " hits " << cache->hits() << " misses " << cache->misses()
+              << " hitrate " << std::fixed << std::setprecision(3) << cache->hitRate()
+              << " memory " << cache->memoryBytes() / 1024 << "KiB";
+        return stats.str();
+    }
+};
+
+/**
+ * @brief Create the GTPGame of a board size.
+ * @param size: the board size.
+ * @return std::unique_ptr<GTPGame>: the game, nullptr if the size is not supported.
+ */
+std::unique_ptr<GTPGame> makeGTPGame(int size)
+{
+    switch (size)
+    {
+        case 5: return std::make_unique<SizedGTPGame<5>>();
+        case 7: return std::make_unique<SizedGTPGame<7>>();
+        case 9: return std::make_unique<SizedGTPGame<9>>();
+        default: return nullptr;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     const std::set<std::string> know_commands = 
@@ -65,14 +191,30 @@ int main(int argc, char *argv[])
         "genmove"
     };
 
-    GoGame game = GoGame();
-    auto ai = TimeLimitMCTSAI("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, 10);
+    // --ponder: search on the opponent's time after genmove, it can be changed by p-ponder
+    // --stats <path>: append the stats of every genmove search to a JSON lines file
+    // --tree-memory <MiB>: the memory budget of the search tree
+    bool ponder = false;
+    std::string statsPath = "";
+    std::size_t maxTreeMemory = MAX_TREE_MEMORY;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--ponder") ponder = true;
+        if (std::string(argv[i]) == "--stats" && i + 1 < argc) statsPath = argv[++i];
+        if (std::string(argv[i]) == "--tree-memory" && i + 1 < argc) maxTreeMemory = std::stoull(argv[++i]) << 20;
+    }
+
+    std::unique_ptr<GTPGame> game = makeGTPGame(BOARD_SIZE);
+    game->setStatsPath(statsPath);
+    game->setMaxTreeMemory(maxTreeMemory);
     float black_wr = 0.0;
 
     while (true)
     {
         std::string input;
         std::getline(std::cin, input);
+        // every command stops pondering, the tree is handed to the next genmove by the moves played
+        game->stopPondering();
         removeControlCharsExceptHTandLF(input);   // 删除所有出现的 CR 和其他控制字符（HT 和 LF 除外）。
         removeAfterCharacter(input, '#');         // 对于带有井号 (#) 的每一行，删除该字符后面（包括该字符）的所有文本。
         std::replace(input.begin(), input.end(), '\t', ' ');  // 将所有出现的 HT 转换为 SPACE。
@@ -150,16 +292,32 @@ int main(int argc, char *argv[])
                 continue;
             }
             int size = std::stoi(args[0]);
-            if (size != 5)
+            if (size != game->getSize())
             {
-                errorOutput(id, "unacceptable size");
-                continue;
+                // the model of the size may not exist, keep the current game then
+                std::unique_ptr<GTPGame> sizedGame;
+                try
+                {
+                    sizedGame = makeGTPGame(size);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << e.what() << std::endl;
+                }
+                if (sizedGame == nullptr)
+                {
+                    errorOutput(id, "unacceptable size");
+                    continue;
+                }
+                game = std::move(sizedGame);
+                game->setStatsPath(statsPath);
+                game->setMaxTreeMemory(maxTreeMemory);
             }
             successOutput(id, "");
         }
         else if (command == "clear_board")
         {
-            game = GoGame();
+            game->clear();
             successOutput(id, "");
         }
         else if (command == "komi")
@@ -170,7 +328,7 @@ int main(int argc, char *argv[])
                 continue;
             }
             float komi = std::stof(args[0]);
-            if (komi != 2.5)
+            if (komi != KOMI)
             {
                 errorOutput(id, "unacceptable komi");
                 continue;
@@ -186,7 +344,7 @@ int main(int argc, char *argv[])
             }
             if (args[0] == "black" || args[0] == "B")
             {
-                if (game.getNowPiece() != Player::Black)
+                if (game->getNowPiece() != Player::Black)
                 {
                     errorOutput(id, "illegal move");
                     continue;
@@ -194,7 +352,7 @@ int main(int argc, char *argv[])
             }
             else if (args[0] == "white" || args[0] == "W")
             {
-                if (game.getNowPiece() != Player::White)
+                if (game->getNowPiece() != Player::White)
                 {
                     errorOutput(id, "illegal move");
                     continue;
@@ -210,13 +368,14 @@ int main(int argc, char *argv[])
 
             if(args[1] == "pass")
             {
-                result = game.move(-1, -1);
+                result = game->move(-1, -1);
             }
             else
             {
-                int x = args[1][0] - 'A';
-                int y = args[1][1] - '1';
-                result = game.move(x,y);
+                int x = gtpLetterIndex(args[1][0]);
+                int y = std::atoi(args[1].c_str() + 1) - 1;
+                int size = game->getSize();
+                result = x >= 0 && x < size && y >= 0 && y < size && game->move(x,y);
             }
 
             if (result)
@@ -239,7 +398,7 @@ int main(int argc, char *argv[])
             
             if (color == "black" || color == "B")
             {
-                if (game.getNowPiece() != Player::Black)
+                if (game->getNowPiece() != Player::Black)
                 {
                     errorOutput(id, "illegal move");
                     continue;
@@ -247,7 +406,7 @@ int main(int argc, char *argv[])
             }
             else if (color == "white" || color == "W")
             {
-                if (game.getNowPiece() != Player::White)
+                if (game->getNowPiece() != Player::White)
                 {
                     errorOutput(id, "illegal move");
                     continue;
@@ -259,15 +418,15 @@ int main(int argc, char *argv[])
                 continue;
             }
 
-            if (game.isGameOver())
+            if (game->isGameOver())
             {
                 successOutput(id, "pass");
                 continue;
             }
 
-            auto [i, j, bwr] = ai.evaMove(game);
+            auto [i, j, bwr] = game->evaMove();
             black_wr = bwr;
-            game.move(i, j);
+            game->move(i, j);
 
             if (i == -1)
             {
@@ -275,22 +434,24 @@ int main(int argc, char *argv[])
             }
             else
             {
-                successOutput(id, std::string(1, 'A' + i) + std::to_string(j + 1));
+                successOutput(id, std::string(1, gtpLetter(i)) + std::to_string(j + 1));
             }
 
             std::cout << "\nblack win rate:" << std::fixed << std::setprecision(2) << bwr << std::endl;
+
+            if (ponder) game->startPondering();
         }
         else if (command == "p-nmove")
         {
-            successOutput(id, std::to_string(game.getNMove()));
+            successOutput(id, std::to_string(game->getNMove()));
         }
         else if (command == "p-winner")
         {
-            if (game.judgeWinner() == Player::Black)
+            if (game->judgeWinner() == Player::Black)
             {
                 successOutput(id, "black");
             }
-            else if (game.judgeWinner() == Player::White)
+            else if (game->judgeWinner() == Player::White)
             {
                 successOutput(id, "white");
             }
@@ -303,6 +464,38 @@ int main(int argc, char *argv[])
         {
             successOutput(id, std::to_string(black_wr));
         }
+        else if (command == "p-ponder")
+        {
+            if (args.size() < 1 || (args[0] != "on" && args[0] != "off"))
+            {
+                errorOutput(id, "p-ponder requires on or off");
+                continue;
+            }
+            ponder = (args[0] == "on");
+            successOutput(id, "");
+        }
+        else if (command == "p-stats")
+        {
+            successOutput(id, game->searchStats());
+        }
+        else if (command == "p-cache")
+        {
+            successOutput(id, game->cacheStats());
+        }
+        else if (command == "p-cache-size")
+        {
+            // a number too large for size_t is refused as well, instead of throwing
+            std::size_t cacheSize = 0;
+            auto parsed = (args.size() < 1) ? std::from_chars_result{nullptr, std::errc::invalid_argument}
+                                            : std::from_chars(args[0].data(), args[0].data() + args[0].size(), cacheSize);
+            if (parsed.ec != std::errc() || parsed.ptr != args[0].data() + args[0].size())
+            {
+                errorOutput(id, "p-cache-size requires a number of positions");
+                continue;
+            }
+            game->setCacheSize(cacheSize);
+            successOutput(id, "");
+        }
         else
         {
             errorOutput(id, "unknown command");
@@ -0,0 +1,306 @@
+# include "BitboardGoGame.h"
+
+template<int N>
+BasicBitboardGoGame<N>::BasicBitboardGoGame(int* board, int* previousBoard, int nowPiece, int nMove):BasicBitboardGoGame()
+{
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            placeStone(i, j, static_cast<Stone>(board[i * N + j]));
+            auto previous = static_cast<Stone>(previousBoard[i * N + j]);
+            if (previous == Stone::Black) _previousBlack |= pointMask<N>(i, j);
+            else if (previous == Stone::White) _previousWhite |= pointMask<N>(i, j);
+        }
+    }
+    _nowPiece = static_cast<Player>(nowPiece);
+
+    int nBlack = popCount(_black); int nWhite = popCount(_white);
+    if (nMove == -1)
+    {
+        // guess the _nMove
+        if (_nowPiece == Player::Black)
+        {
+            _nMove = 2 * std::max(nBlack, nWhite);
+        }
+        else
+        {
+            _nMove = 2 * std::max(nBlack - 1, nWhite) + 1;
+        }
+    }
+    else
+    {
+        // do not guess the _nMove
+        _nMove = nMove;
+    }
+}
+
+template<int N>
+typename BasicBitboardGoGame<N>::BoardMask BasicBitboardGoGame<N>::stonesOf(Stone stone) const
+{
+    return (stone == Stone::Black) ? _black : _white;
+}
+
+template<int N>
+typename BasicBitboardGoGame<N>::BoardMask BasicBitboardGoGame<N>::emptyPoints() const
+{
+    return FULL_MASK<N> & ~(_black | _white);
+}
+
+template<int N>
+typename BasicBitboardGoGame<N>::BoardMask BasicBitboardGoGame<N>::groupOf(int i, int j) const
+{
+    auto point = pointMask<N>(i, j);
+    if (_black & point) return floodFill<N>(point, _black);
+    if (_white & point) return floodFill<N>(point, _white);
+    return 0;
+}
+
+template<int N>
+const Neighbors& BasicBitboardGoGame<N>::getNeighbors(int i, int j) const
+{
+    return NEIGHBOR_TABLE<N>[i * N + j];
+}
+
+template<int N>
+bool BasicBitboardGoGame<N>::isLegal(int i, int j, Stone stone) const
+{
+    if (stone == Stone::Empty) return false;
+    if (i < 0 || i >= N || j < 0 || j >= N) return false;
+    auto point = pointMask<N>(i, j);
+    if (!(emptyPoints() & point)) return false;
+
+    auto empty    = emptyPoints();
+    auto own      = stonesOf(stone);
+    auto opponent = (stone == Stone::Black) ? _white : _black;
+
+    // an empty neighbor always makes the placement legal
+    if (adjacentMask<N>(point) & empty) return true;
+
+    // neighbors are visited in the same order as GoGame, so the KO rule is checked on the same group
+    for (auto [x, y] : getNeighbors(i, j))
+    {
+        auto neighbor  = pointMask<N>(x, y);
+        bool isOwn     = own & neighbor;
+        auto group     = floodFill<N>(neighbor, isOwn ? own : opponent);
+        int  liberties = popCount(adjacentMask<N>(group) & empty);
+
+        // if there is a stone of the same color with more than 1 liberty, it is legal
+        if (isOwn)
+        {
+            if (liberties > 1) return true;
+        }
+        // if there is a stone of the opposite color with only 1 liberty, it is legal
+        else if (liberties == 1)
+        {
+            // check KO rule
+            if (group == neighbor)
+            {
+                auto newOwn      = own | point;
+                auto newOpponent = opponent & ~neighbor;
+                auto newBlack    = (stone == Stone::Black) ? newOwn : newOpponent;
+                auto newWhite    = (stone == Stone::Black) ? newOpponent : newOwn;
+                if (newBlack == _previousBlack && newWhite == _previousWhite)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<int N>
+typename BasicBitboardGoGame<N>::MoveList BasicBitboardGoGame<N>::getPossiblePlacements() const
+{
+    MoveList possiblePlacements{};
+    auto empty = emptyPoints();
+    // points with an empty neighbor are always legal, only the others need the full check
+    auto free  = empty & adjacentMask<N>(empty);
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            auto point = pointMask<N>(i, j);
+            if (!(empty & point)) continue;
+            if ((free & point) || isLegal(i, j, static_cast<Stone>(_nowPiece)))
+            {
+                possiblePlacements.push_back({i, j});
+            }
+        }
+    }
+    return possiblePlacements;
+}
+
+template<int N>
+bool BasicBitboardGoGame<N>::placeStone(int i, int j, Stone stone)
+{
+    if (stone == Stone::Empty) return false;
+    auto point = pointMask<N>(i, j);
+    if (!(emptyPoints() & point)) return false;
+    if (stone == Stone::Black) _black |= point;
+    else                       _white |= point;
+    return true;
+}
+
+template<int N>
+void BasicBitboardGoGame<N>::removeNeighborGroups(int i, int j, Stone stone)
+{
+    auto empty    = emptyPoints();
+    auto opponent = (stone == Stone::Black) ? _white : _black;
+    auto around   = adjacentMask<N>(pointMask<N>(i, j)) & opponent;
+    while (around)
+    {
+        auto group = floodFill<N>(around & -around, opponent);
+        around &= ~group;
+        if (!(adjacentMask<N>(group) & empty))
+        {
+            _black &= ~group;
+            _white &= ~group;
+        }
+    }
+}
+
+template<int N>
+void BasicBitboardGoGame<N>::removeGroup(int i, int j)
+{
+    auto group = groupOf(i, j);
+    _black &= ~group;
+    _white &= ~group;
+}
+
+template<int N>
+bool BasicBitboardGoGame<N>::move(int i, int j)
+{
+    if (!(i == -1 && j ==-1) && !isLegal(i, j, static_cast<Stone>(_nowPiece))) return false;
+    if (_isGameOver) return false;
+
+    auto tempBlack = _previousBlack;
+    auto tempWhite = _previousWhite;
+    _previousBlack = _black;
+    _previousWhite = _white;
+    // if the move is not pass, place the stone and remove the the opponent's group of stones if it has no liberty
+    if (!(i == -1 && j ==-1))
+    {
+        placeStone(i, j, static_cast<Stone>(_nowPiece));
+        removeNeighborGroups(i, j, static_cast<Stone>(_nowPiece));
+    }
+    _nMove += 1;
+    _nowPiece = (_nowPiece == Player::Black) ? Player::White : Player::Black;
+
+    // check if the game is over
+    // Case 1: the number of moves reaches the maximum
+    if (_nMove >= _maxMove) _isGameOver = true;
+    // Case 2: two players all pass
+    if (i == -1 && j == -1 && tempBlack == _black && tempWhite == _white && _nMove >= 2) _isGameOver = true;
+
+    return true;
+}
+
+template<int N>
+bool BasicBitboardGoGame<N>::isGameOver() const
+{
+    return _isGameOver;
+}
+
+template<int N>
+void BasicBitboardGoGame<N>::showBoard() const
+{
+    std::cout << "Board:" << std::endl;
+    std::cout << " ";
+    for (int j = 0; j < N; j++) std::cout << " " << j;
+    std::cout << std::endl;
+    std::cout << "  " << std::string(N * 2, '=') << std::endl;
+    for (int i = 0; i < N; i++)
+    {
+        std::cout << i << "|";
+        for (int j = 0; j < N; j++)
+        {
+            auto stone = getStone(i, j);
+            if (stone == Stone::Empty)
+            {
+                std::cout << "  ";
+            }
+            else if (stone == Stone::Black)
+            {
+                std::cout << "X ";
+            }
+            else if (stone == Stone::White)
+            {
+                std::cout << "O ";
+            }
+        }
+        std::cout << "|" << std::endl;
+    }
+    std::cout << "  " << std::string(N * 2, '=') << std::endl;
+}
+
+template<int N>
+void BasicBitboardGoGame<N>::showLiberties() const
+{
+    std::cout << "Liberties:" << std::endl;
+    std::cout << std::string(N * 2, '=') << std::endl;
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            auto lNum = getLibertyNum(i, j);
+            if (lNum < 0)
+                std::cout <<  "  ";
+            else
+                std::cout << lNum << " ";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::string(N * 2, '=') << std::endl;
+}
+
+template<int N>
+Player BasicBitboardGoGame<N>::judgeWinner(bool isPrint) const
+{
+    float nBlack = popCount(_black); float nWhite = KOMI + popCount(_white);
+
+    Player winner = (nBlack > nWhite) ? Player::Black : Player::White;
+    if (isPrint)
+    {
+        std::cout << "Black: " << nBlack << std::endl;
+        std::cout << "White: " << nWhite << std::endl;
+        std::cout << "Winner: " << ((winner == Player::Black) ? "Black" : "White") << std::endl;
+    }
+    return winner;
+}
+
+template<int N>
+Player BasicBitboardGoGame<N>::getNowPiece() const
+{
+    return _nowPiece;
+}
+
+template<int N>
+Stone BasicBitboardGoGame<N>::getStone(int i, int j) const
+{
+    auto point = pointMask<N>(i, j);
+    if (_black & point) return Stone::Black;
+    if (_white & point) return Stone::White;
+    return Stone::Empty;
+}
+
+template<int N>
+int BasicBitboardGoGame<N>::getLibertyNum(int i, int j) const
+{
+    auto group = groupOf(i, j);
+    if (!group) return -1;
+    return popCount(adjacentMask<N>(group) & emptyPoints());
+}
+
+template<int N>
+int BasicBitboardGoGame<N>::getNMove() const
+{
+    return _nMove;
+}
+
+template class BasicBitboardGoGame<5>;
+template class BasicBitboardGoGame<7>;
+template class BasicBitboardGoGame<9>;
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <iostream>
+
+#include "GoGame.h"
+#include "../utils/BitMask.hpp"
+
+/**
+ * @brief The BitboardGoGame class.
+ * 
+ * A bitboard backend of the rules, only used by bench.cpp to compare it with GoGame.
+ * It has the rules API of the random games, but not the hashes, makeMove/undoMove, the legal mask
+ * and the position keys of GoGame which the search uses, so it does not replace GoGame in MCTS.
+ * Instead of a Board and a PieceGroupMap, the black and white stones are saved as two BoardMasks,
+ * groups and liberties are computed by flood fills with shifts, so copying a game is copying a few integers.
+ * Like GoGame, it is a template on the board size N, BitboardGoGame is the class of BOARD_SIZE.
+ */
+template<int N>
+class BasicBitboardGoGame
+{
+    public:
+        typedef BasicBoardMask<N> BoardMask;
+        typedef BasicMoveList<N>  MoveList;
+
+    private:
+        // The black stones of the game.
+        BoardMask     _black         = 0;
+        // The white stones of the game.
+        BoardMask     _white         = 0;
+        // The black stones of the previous board.
+        BoardMask     _previousBlack = 0;
+        // The white stones of the previous board.
+        BoardMask     _previousWhite = 0;
+        // Now piece to move.
+        Player        _nowPiece      = Player::Black;
+        // The number of moves which have been made.
+        int           _nMove         = 0;
+        // is the game over.
+        bool          _isGameOver    = false;
+        // The maximum number of moves that can be made.
+        static constexpr int _maxMove = N * N - 1;
+
+        /**
+         * @brief Get the mask of stones of a specific color.
+         * @param stone: the color of stones, must not be Stone::Empty.
+         * @return BoardMask: the stones.
+         */
+        BoardMask stonesOf(Stone stone) const;
+
+        /**
+         * @brief Get the mask of empty points.
+         * @return BoardMask: the empty points.
+         */
+        BoardMask emptyPoints() const;
+
+        /**
+         * @brief Get the group of stones which contains a specific point.
+         * @param i: the row index of the stone.
+         * @param j: the column index of the stone.
+         * @return BoardMask: the stones of the group, 0 if the point is empty.
+         */
+        BoardMask groupOf(int i, int j) const;
+
+    public:
+        BasicBitboardGoGame()                                           = default;
+        BasicBitboardGoGame(const BasicBitboardGoGame& game)            = default;
+        BasicBitboardGoGame(BasicBitboardGoGame&& game)                 = default;
+        BasicBitboardGoGame& operator=(const BasicBitboardGoGame& game) = default;
+        BasicBitboardGoGame& operator=(BasicBitboardGoGame&& game)      = default;
+        ~BasicBitboardGoGame()                                          = default;
+
+        /**
+         * @brief Construct a new BitboardGoGame object, copy the board, previous board and now piece given by python.
+         * @param board: the current board, ctypes array of size board_size * board_size. 0 for empty, 1 for black, 2 for white.
+         * @param previousBoard: the previous board, ctypes array of size board_size * board_size. 0 for empty, 1 for black, 2 for white.
+         * @param nowPiece: the piece that should be placed. 1 for black, 2 for white.
+         * @param nMove: the number of moves which have been made. -1 for not given.
+         */
+        BasicBitboardGoGame(int* board, int* previousBoard, int nowPiece, int nMove = -1);
+
+        /**
+         * @brief Get the neighbors of a point.
+         * @param i: the row index of the point.
+         * @param j: the column index of the point.
+         * @return const Neighbors&: the neighbors of the point.
+         */
+        const Neighbors& getNeighbors(int i, int j) const;
+
+        /**
+         * @brief Check whether a placement is legal.
+         * @param i: the row index of the placement.
+         * @param j: the column index of the placement.
+         * @param stone: the stone to be placed.
+         * @return bool: whether the placement is legal.
+        */
+        bool isLegal(int i, int j, Stone stone) const;
+
+        /**
+         * @brief Get the possible placements of the next stone.
+         * @return MoveList: the possible placements.
+         */
+        MoveList getPossiblePlacements() const;
+
+        /**
+         * @brief place a stone on the board.
+         * @return bool: whether the placement is successful.
+         */
+        bool placeStone(int i, int j, Stone stone);
+
+        /**
+         * @brief Remove the groups of stones which have no liberty.
+         * @param i: the row index of the stone has been placed.
+         * @param j: the column index of the stone has been placed.
+         * @param stone: the stone has been placed.
+         */
+        void removeNeighborGroups(int i, int j, Stone stone);
+
+        /**
+         * @brief Remove a group of stones.
+         * @param i: the row index of the stone.
+         * @param j: the column index of the stone.
+         */
+        void removeGroup(int i, int j);
+
+        /**
+         * @brief Move a mvoe
+         * @param i: the row index of the placement.
+         * @param j: the column index of the placement.
+         * @return bool: whether the move is successful.
+         */
+        bool move(int i, int j);
+
+        /**
+         * @brief Show the board.
+         */
+        void showBoard() const;
+
+        /**
+         * @brief Show the liberties of the groups of stones.
+         */
+        void showLiberties() const;
+
+        /**
+         * @brief Check whether the game is over.
+         * @return bool: whether the game is over.
+         */
+        bool isGameOver() const;
+        
+        /**
+         * @brief Judge the winner of the game.
+         * @param isPrint: whether to print to the console.
+         * @return Player: the winner of the game.
+         */
+        Player judgeWinner(bool isPrint = false) const;
+
+        /**
+         * @brief Now piece to move.
+         * @return Player: the now piece to move.
+         */
+        Player getNowPiece() const;
+
+        /**
+         * @brief Get the stone at a specific point.
+         * @param i: the row index of the point.
+         * @param j: the column index of the point.
+         * @return Stone: the stone at the point.
+         */
+        Stone getStone(int i, int j) const;
+
+        /**
+         * @brief Get the number of liberties of a group of stones with a specific stone.
+         * @param i: the row index of the stone.
+         * @param j: the column index of the stone.
+         * @return int: the number of liberties, -1 if the point is empty.
+        */
+        int getLibertyNum(int i, int j) const;
+
+        /**
+         * @brief Get the number of moves which have been made.
+         * @return int: the number of moves which have been made.
+        */
+        int getNMove() const;
+};
+
+typedef BasicBitboardGoGame<BOARD_SIZE> BitboardGoGame;
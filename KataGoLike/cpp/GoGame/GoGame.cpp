@@ -1,136 +1,168 @@
 # include "GoGame.h"
 
-int boardPairToInt(Point p)
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::addStone(int i, int j)
 {
-    if (p == std::make_pair(-1, -1)) return -1;
-    return p.first * BOARD_SIZE + p.second;
-}
-
-Point boardIntToPair(int i)
-{
-    if (i == -1) return std::make_pair(-1, -1);
-    return {i / BOARD_SIZE, i % BOARD_SIZE};
-}
-
-void GoGame::PieceGroupMap::addStone(int i, int j)
-{
-    auto pos = std::make_pair(i, j);
+    auto pos = i * N + j;
     // parent is itself
-    _parent[pos]    = std::make_pair(i, j);
+    _parent[pos]    = pos;
     // children of a stone include itself
-    _children[pos]  = {std::make_pair(i, j)};
+    _children[pos]  = pointMask<N>(i, j);
     // liberties is empty
-    _liberties[pos] = {};
+    _liberties[pos] = 0;
 }
 
-void GoGame::PieceGroupMap::addLiberty(int i, int j, int x, int y)
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::addLiberty(int i, int j, int x, int y)
 {
-    auto parent = _parent.at({i, j});
-    _liberties[parent].insert({x, y});
+    _liberties[_parent[i * N + j]] |= pointMask<N>(x, y);
 }
 
-void GoGame::PieceGroupMap::removeLiberty(int i, int j, int x, int y)
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::removeLiberty(int i, int j, int x, int y)
 {
-    auto parent = _parent.at({i, j});
-    _liberties[parent].erase({x, y});
+    _liberties[_parent[i * N + j]] &= ~pointMask<N>(x, y);
 }
 
-void GoGame::PieceGroupMap::merge(int i1, int j1, int i2, int j2)
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::merge(int i1, int j1, int i2, int j2)
 {
     // find
-    auto parent1 = _parent.at({i1, j1});
-    auto parent2 = _parent.at({i2, j2});
+    auto parent1 = _parent[i1 * N + j1];
+    auto parent2 = _parent[i2 * N + j2];
 
     // if these two in the same group return
     if (parent1 == parent2) return;
 
     // remove each other in liberties
-    _liberties[parent1].erase({i2, j2});
-    _liberties[parent2].erase({i1, j1});
+    _liberties[parent1] &= ~pointMask<N>(i2, j2);
+    _liberties[parent2] &= ~pointMask<N>(i1, j1);
 
     // make sure the group of parent1 is larger than the group of parent2
-    if (_children[parent1].size() < _children[parent2].size())
+    if (popCount(_children[parent1]) < popCount(_children[parent2]))
     {
         std::swap(parent1, parent2);
     }
 
     // all stones of group2 become stones of group1
-    for (auto child : _children[parent2])
+    for (auto children = _children[parent2]; children; children &= children - 1)
     {
-        _parent[child] = parent1;
-        _children[parent1].insert(child);
+        _parent[lowestPoint(children)] = parent1;
     }
-    _children.erase(parent2);
+    _children[parent1] |= _children[parent2];
+    _children[parent2]  = 0;
 
     // all liberties of group2 become liberties of group1
-    for (auto liberty : _liberties[parent2])
-    {
-        _liberties[parent1].insert(liberty);
-    }
-    _liberties.erase(parent2);
+    _liberties[parent1] |= _liberties[parent2];
+    _liberties[parent2]  = 0;
+}
+
+template<int N>
+int BasicGoGame<N>::PieceGroupMap::getLibertyNum(int i, int j) const
+{
+    auto parent = _parent[i * N + j];
+    if (parent == NO_PARENT) return -1;
+    return popCount(_liberties[parent]);
+}
+
+template<int N>
+int BasicGoGame<N>::PieceGroupMap::getChildrenNum(int i, int j) const
+{
+    auto parent = _parent[i * N + j];
+    if (parent == NO_PARENT) return -1;
+    return popCount(_children[parent]);
 }
 
-int GoGame::PieceGroupMap::getLibertyNum(int i, int j) const
+template<int N>
+typename BasicGoGame<N>::BoardMask BasicGoGame<N>::PieceGroupMap::getChildren(int i, int j) const
 {
-    if (!_parent.contains({i, j})) return -1;
-    auto parent = _parent.at({i, j});
-    return _liberties.at(parent).size();
+    auto parent = _parent[i * N + j];
+    if (parent == NO_PARENT) 
+        throw std::out_of_range("The position is not in the board");
+    return _children[parent];
 }
 
-int GoGame::PieceGroupMap::getChildrenNum(int i, int j) const
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::removeGroup(int i, int j)
 {
-    if (!_parent.contains({i, j})) return -1;
-    auto parent = _parent.at({i, j});
-    return _children.at(parent).size();
+    auto parent = _parent[i * N + j];
+    for (auto children = _children[parent]; children; children &= children - 1)
+    {
+        _parent[lowestPoint(children)] = NO_PARENT;
+    }
+    _children[parent]  = 0;
+    _liberties[parent] = 0;
 }
 
-const std::set<Point>& GoGame::PieceGroupMap::getChildren(int i, int j) const
+template<int N>
+typename BasicGoGame<N>::BoardMask BasicGoGame<N>::PieceGroupMap::getLiberties(int i, int j) const
 {
-    if (!_parent.contains({i, j})) 
+    auto parent = _parent[i * N + j];
+    if (parent == NO_PARENT) 
         throw std::out_of_range("The position is not in the board");
-    auto parent = _parent.at({i, j});
-    return _children.at(parent);
+    return _liberties[parent];
 }
 
-void GoGame::PieceGroupMap::removeGroup(int i, int j)
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::removeLiberties(int i, int j, BoardMask liberties)
 {
-    auto parent = _parent.at({i, j});
-    for (auto child : _children[parent])
+    _liberties[_parent[i * N + j]] &= ~liberties;
+}
+
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::setGroup(BoardMask children, BoardMask liberties)
+{
+    auto parent = lowestPoint(children);
+    for (auto c = children; c; c &= c - 1)
     {
-        _parent.erase(child);
+        _parent[lowestPoint(c)] = parent;
     }
-    _children.erase(parent);
-    _liberties.erase(parent);
+    _children[parent]  = children;
+    _liberties[parent] = liberties;
 }
 
+template<int N>
+void BasicGoGame<N>::PieceGroupMap::removeStone(int i, int j)
+{
+    _parent[i * N + j] = NO_PARENT;
+}
 
-GoGame::GoGame()
+template<int N>
+BasicGoGame<N>::BasicGoGame()
 {
-    for (int i = 0; i < BOARD_SIZE; i++)
+    for (int i = 0; i < N; i++)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        for (int j = 0; j < N; j++)
         {
-            _board[i][j]         = Stone::Empty;
-            _previousBoard[i][j] = Stone::Empty;
+            _board[i][j] = Stone::Empty;
         }
     }
+    // the previous board of a new game is also empty
+    pushHistory(_hash);
 }
 
-GoGame::GoGame(int* board, int* previousBoard, int nowPiece, int nMove):GoGame()
+template<int N>
+BasicGoGame<N>::BasicGoGame(int* board, int* previousBoard, int nowPiece, int nMove):BasicGoGame()
 {
     int nBlack = 0; int nWhite = 0;
-    for (int i = 0; i < BOARD_SIZE; i++)
+    uint64_t previousHash = 0;
+    for (int i = 0; i < N; i++)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        for (int j = 0; j < N; j++)
         {
-            placeStone(i, j, static_cast<Stone>(board[i * BOARD_SIZE + j]));
-            _previousBoard[i][j] = static_cast<Stone>(previousBoard[i * BOARD_SIZE + j]);
+            placeStone(i, j, static_cast<Stone>(board[i * N + j]));
+            if (previousBoard[i * N + j] != 0)
+                previousHash ^= zobristKey<N>(previousBoard[i * N + j], i, j);
 
             if (_board[i][j] == Stone::Black) nBlack += 1;
             else if (_board[i][j] == Stone::White) nWhite += 1;
         }
     }
+    _historySize = 0;
+    pushHistory(previousHash);
     _nowPiece = static_cast<Player>(nowPiece);
+    updateLegalMask(FULL_MASK<N>);
+    updateKoBan(FULL_MASK<N>);
 
     if (nMove == -1)
     {
@@ -152,21 +184,55 @@ GoGame::GoGame(int* board, int* previousBoard, int nowPiece, int nMove):GoGame()
     
 }
 
-std::vector<Point> GoGame::getNeighbors(int i, int j) const
+template<int N>
+void BasicGoGame<N>::pushHistory(uint64_t hash)
 {
-    std::vector<Point> neighbors{};
-    if (i - 1 >= 0)         neighbors.push_back(std::make_pair(i - 1, j));
-    if (i + 1 < BOARD_SIZE) neighbors.push_back(std::make_pair(i + 1, j));
-    if (j - 1 >= 0)         neighbors.push_back(std::make_pair(i, j - 1));
-    if (j + 1 < BOARD_SIZE) neighbors.push_back(std::make_pair(i, j + 1));
-    return neighbors;
+    _historyHead = (_historyHead + 1) % KO_HISTORY_SIZE;
+    _history[_historyHead] = hash;
+    _historySize = std::min(_historySize + 1, KO_HISTORY_SIZE);
 }
 
-bool GoGame::isLegal(int i, int j, Stone stone) const
+template<int N>
+bool BasicGoGame<N>::isRepetition(uint64_t hash) const
+{
+    for (int k = 0; k < _historySize; k++)
+    {
+        if (_history[(_historyHead - k + KO_HISTORY_SIZE) % KO_HISTORY_SIZE] == hash) return true;
+    }
+    return false;
+}
+
+template<int N>
+uint64_t BasicGoGame<N>::hashAfterPlacement(int i, int j, Stone stone) const
+{
+    uint64_t hash = _hash ^ zobristKey<N>(static_cast<int>(stone), i, j);
+    BoardMask captured = 0;
+    for (auto [x, y] : getNeighbors(i, j))
+    {
+        if (_board[x][y] == Stone::Empty || _board[x][y] == stone) continue;
+        if (_pieceGroupMap.getLibertyNum(x, y) != 1) continue;
+        captured |= _pieceGroupMap.getChildren(x, y);
+    }
+    for (; captured; captured &= captured - 1)
+    {
+        auto [x, y] = boardIntToPair<N>(lowestPoint(captured));
+        hash ^= zobristKey<N>(static_cast<int>(_board[x][y]), x, y);
+    }
+    return hash;
+}
+
+template<int N>
+const Neighbors& BasicGoGame<N>::getNeighbors(int i, int j) const
+{
+    return NEIGHBOR_TABLE<N>[i * N + j];
+}
+
+template<int N>
+bool BasicGoGame<N>::isLegal(int i, int j, Stone stone) const
 {
     if (stone == Stone::Empty) return false;
     if (_board[i][j] != Stone::Empty) return false;
-    if (i < 0 || i >= BOARD_SIZE || j < 0 || j >= BOARD_SIZE) return false;
+    if (i < 0 || i >= N || j < 0 || j >= N) return false;
 
     // check
     bool legal = false;
@@ -197,10 +263,9 @@ bool GoGame::isLegal(int i, int j, Stone stone) const
                 // check KO rule
                 if (_pieceGroupMap.getChildrenNum(x, y) == 1)
                 {
-                    Board tempBoard = _board;
-                    tempBoard[x][y] = Stone::Empty;
-                    tempBoard[i][j] = stone;
-                    if (tempBoard == _previousBoard)
+                    uint64_t hash = _hash ^ zobristKey<N>(static_cast<int>(stone), i, j)
+                                          ^ zobristKey<N>(static_cast<int>(_board[x][y]), x, y);
+                    if (hash == _history[_historyHead])
                     {
                         return false;
                     }
@@ -210,30 +275,84 @@ bool GoGame::isLegal(int i, int j, Stone stone) const
         }
     }
 
+    // check positional superko, no board in the history can appear again
+    if constexpr (USE_SUPERKO)
+    {
+        if (legal && isRepetition(hashAfterPlacement(i, j, stone))) return false;
+    }
+
     return legal;
 }
 
-std::vector<Point> GoGame::getPossiblePlacements() const
+template<int N>
+void BasicGoGame<N>::updateLegalMask(BoardMask points)
 {
-    std::vector<Point> possiblePlacements{};
-    for (int i = 0; i < BOARD_SIZE; i++)
+    for (; points; points &= points - 1)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        int index = lowestPoint(points);
+        auto [i, j] = boardIntToPair<N>(index);
+        auto point  = BoardMask(1) << index;
+        _legalMask[0] &= ~point;
+        _legalMask[1] &= ~point;
+        if (_board[i][j] != Stone::Empty) continue;
+
+        // an empty neighbor, a group of the same color with more than 1 liberty,
+        // or a group of the opposite color with only 1 liberty makes it legal
+        bool blackLegal = false; bool whiteLegal = false;
+        for (auto [x, y] : getNeighbors(i, j))
         {
-            if (isLegal(i, j, static_cast<Stone>(_nowPiece)))
+            if (_board[x][y] == Stone::Empty)
             {
-                possiblePlacements.push_back({i, j});
+                blackLegal = whiteLegal = true;
+                break;
             }
+            int libertyNum = _pieceGroupMap.getLibertyNum(x, y);
+            bool isBlack   = (_board[x][y] == Stone::Black);
+            blackLegal |= isBlack ? (libertyNum > 1) : (libertyNum == 1);
+            whiteLegal |= isBlack ? (libertyNum == 1) : (libertyNum > 1);
         }
+        if (blackLegal) _legalMask[0] |= point;
+        if (whiteLegal) _legalMask[1] |= point;
+    }
+}
+
+template<int N>
+void BasicGoGame<N>::updateKoBan(BoardMask candidates)
+{
+    _koBan = 0;
+    auto stone = static_cast<Stone>(_nowPiece);
+    for (candidates &= _legalMask[static_cast<int>(stone) - 1]; candidates; candidates &= candidates - 1)
+    {
+        int index = lowestPoint(candidates);
+        auto [i, j] = boardIntToPair<N>(index);
+        if (!isLegal(i, j, stone)) _koBan |= BoardMask(1) << index;
+    }
+}
+
+template<int N>
+typename BasicGoGame<N>::BoardMask BasicGoGame<N>::getLegalMask() const
+{
+    return _legalMask[static_cast<int>(_nowPiece) - 1] & ~_koBan;
+}
+
+template<int N>
+typename BasicGoGame<N>::MoveList BasicGoGame<N>::getPossiblePlacements() const
+{
+    MoveList possiblePlacements{};
+    for (auto legal = getLegalMask(); legal; legal &= legal - 1)
+    {
+        possiblePlacements.push_back(boardIntToPair<N>(lowestPoint(legal)));
     }
     return possiblePlacements;
 }
 
-bool GoGame::placeStone(int i, int j, Stone stone)
+template<int N>
+bool BasicGoGame<N>::placeStone(int i, int j, Stone stone)
 {
     if (stone == Stone::Empty) return false;
     if (_board[i][j] != Stone::Empty) return false;
     _board[i][j] = stone;
+    _hash ^= zobristKey<N>(static_cast<int>(stone), i, j);
     _pieceGroupMap.addStone(i, j);
     for (auto [x, y] : getNeighbors(i, j))
     {   
@@ -256,26 +375,33 @@ bool GoGame::placeStone(int i, int j, Stone stone)
     return true;
 }
 
-void GoGame::removeNeighborGroups(int i, int j, Stone stone)
+template<int N>
+typename BasicGoGame<N>::BoardMask BasicGoGame<N>::removeNeighborGroups(int i, int j, Stone stone)
 {
     Stone opponent = (stone == Stone::Black) ? Stone::White : Stone::Black;
+    BoardMask removed = 0;
     for (auto [x, y] : getNeighbors(i, j))
     {
         if (_board[x][y] == opponent)
         {
             if (_pieceGroupMap.getLibertyNum(x, y) == 0)
             {
+                removed |= _pieceGroupMap.getChildren(x, y);
                 removeGroup(x, y);
             }
         }
     }
+    return removed;
 }
 
-void GoGame::removeGroup(int i, int j)
+template<int N>
+void BasicGoGame<N>::removeGroup(int i, int j)
 {
     Stone opponent = (_board[i][j] == Stone::Black) ? Stone::White : Stone::Black;
-    for (auto [x, y] : _pieceGroupMap.getChildren(i, j))
+    for (auto children = _pieceGroupMap.getChildren(i, j); children; children &= children - 1)
     {
+        auto [x, y] = boardIntToPair<N>(lowestPoint(children));
+        _hash ^= zobristKey<N>(static_cast<int>(_board[x][y]), x, y);
         _board[x][y] = Stone::Empty;
         for (auto [x1, y1] : getNeighbors(x, y))
         {
@@ -288,45 +414,152 @@ void GoGame::removeGroup(int i, int j)
     _pieceGroupMap.removeGroup(i, j);
 }
 
-bool GoGame::move(int i, int j)
+template<int N>
+bool BasicGoGame<N>::move(int i, int j)
 {
-    if (!(i == -1 && j ==-1) && !isLegal(i, j, static_cast<Stone>(_nowPiece))) return false;
+    UndoRecord record;
+    return makeMove(i, j, record);
+}
+
+template<int N>
+bool BasicGoGame<N>::makeMove(int i, int j, UndoRecord& record)
+{
+    if (!(i == -1 && j ==-1) && !(i >= 0 && i < N && j >= 0 && j < N && (getLegalMask() & pointMask<N>(i, j)))) return false;
     if (_isGameOver) return false;
 
-    auto tempBoard = _previousBoard;
-    _previousBoard = _board;
+    record.move               = {i, j};
+    record.captured           = 0;
+    record.hash               = _hash;
+    record.overwrittenHistory = _history[(_historyHead + 1) % KO_HISTORY_SIZE];
+    record.historySize        = _historySize;
+    record.legalMask          = _legalMask;
+    record.koBan              = _koBan;
+
+    auto tempHash = _history[_historyHead];
+    pushHistory(_hash);
     // if the move is not pass, place the stone and remove the the opponent's group of stones if it has no liberty
     if (!(i == -1 && j ==-1))
     {
         placeStone(i, j, static_cast<Stone>(_nowPiece));
-        removeNeighborGroups(i, j, static_cast<Stone>(_nowPiece));
+        record.captured = removeNeighborGroups(i, j, static_cast<Stone>(_nowPiece));
     }
     _nMove += 1;
     _nowPiece = (_nowPiece == Player::Black) ? Player::White : Player::Black;
 
+    // only the points around the changed groups can change their legality
+    if (!(i == -1 && j ==-1))
+    {
+        auto touched = pointMask<N>(i, j) | record.captured;
+        auto around  = adjacentMask<N>(touched);
+        auto dirty   = touched | around | _pieceGroupMap.getLiberties(i, j);
+        for (auto stones = around & ~record.captured; stones; stones &= stones - 1)
+        {
+            auto [x, y] = boardIntToPair<N>(lowestPoint(stones));
+            if (_board[x][y] != Stone::Empty) dirty |= _pieceGroupMap.getLiberties(x, y);
+        }
+        updateLegalMask(dirty);
+    }
+    // a simple KO can only ban the single stone just captured, the superko can ban any point
+    if constexpr (USE_SUPERKO)
+        updateKoBan(FULL_MASK<N>);
+    else
+        updateKoBan(popCount(record.captured) == 1 ? record.captured : 0);
+
     // check if the game is over
     // Case 1: the number of moves reaches the maximum
     if (_nMove >= _maxMove) _isGameOver = true;
     // Case 2: two players all pass
-    if (i == -1 && j == -1 && tempBoard == _board && _nMove >= 2) _isGameOver = true;
+    if (i == -1 && j == -1 && tempHash == _hash && _nMove >= 2) _isGameOver = true;
 
     return true;
 }
 
-bool GoGame::isGameOver() const
+template<int N>
+void BasicGoGame<N>::undoMove(const UndoRecord& record)
+{
+    // a move can only be made when the game is not over
+    _isGameOver = false;
+    _nMove -= 1;
+    _nowPiece = (_nowPiece == Player::Black) ? Player::White : Player::Black;
+    _history[_historyHead] = record.overwrittenHistory;
+    _historyHead = (_historyHead - 1 + KO_HISTORY_SIZE) % KO_HISTORY_SIZE;
+    _historySize = record.historySize;
+    _hash = record.hash;
+    _legalMask = record.legalMask;
+    _koBan = record.koBan;
+
+    auto [i, j] = record.move;
+    if (i == -1 && j == -1) return;
+
+    Stone stone     = _board[i][j];
+    Stone opponent  = (stone == Stone::Black) ? Stone::White : Stone::Black;
+    auto  point     = pointMask<N>(i, j);
+    auto  captured  = record.captured;
+    // the group of the placed stone, it may be merged from several groups
+    auto  group     = _pieceGroupMap.getChildren(i, j);
+    auto  liberties = _pieceGroupMap.getLiberties(i, j);
+
+    // take the stone back and put the captured stones back
+    _board[i][j] = Stone::Empty;
+    _pieceGroupMap.removeStone(i, j);
+    for (auto c = captured; c; c &= c - 1)
+    {
+        auto [x, y] = boardIntToPair<N>(lowestPoint(c));
+        _board[x][y] = opponent;
+    }
+
+    // other groups around the captured stones lose the liberties gained from the capture
+    for (auto around = adjacentMask<N>(captured) & ~group; around; around &= around - 1)
+    {
+        auto [x, y] = boardIntToPair<N>(lowestPoint(around));
+        if (_board[x][y] == stone) _pieceGroupMap.removeLiberties(x, y, captured);
+    }
+
+    // the opponent's groups around the placed stone, which are not captured, get the liberty back
+    for (auto [x, y] : getNeighbors(i, j))
+    {
+        if (_board[x][y] == opponent && !(captured & pointMask<N>(x, y)))
+            _pieceGroupMap.addLiberty(x, y, i, j);
+    }
+
+    // split the group of the placed stone back into the groups it was merged from,
+    // their liberties were empty before the move, so they are the liberties of the group except the captured stones
+    auto rest  = group & ~point;
+    auto empty = (liberties & ~captured) | point;
+    while (rest)
+    {
+        auto part = floodFill<N>(rest & -rest, rest);
+        rest &= ~part;
+        _pieceGroupMap.setGroup(part, adjacentMask<N>(part) & empty);
+    }
+
+    // the captured groups had only one liberty, the placed stone
+    while (captured)
+    {
+        auto part = floodFill<N>(captured & -captured, captured);
+        captured &= ~part;
+        _pieceGroupMap.setGroup(part, point);
+    }
+}
+
+template<int N>
+bool BasicGoGame<N>::isGameOver() const
 {
     return _isGameOver;
 }
 
-void GoGame::showBoard() const
+template<int N>
+void BasicGoGame<N>::showBoard() const
 {
     std::cout << "Board:" << std::endl;
-    std::cout << "  0 1 2 3 4 "<< std::endl;
-    std::cout << "  " << std::string(BOARD_SIZE * 2, '=') << std::endl;
-    for (int i = 0; i < BOARD_SIZE; i++)
+    std::cout << " ";
+    for (int j = 0; j < N; j++) std::cout << " " << j;
+    std::cout << std::endl;
+    std::cout << "  " << std::string(N * 2, '=') << std::endl;
+    for (int i = 0; i < N; i++)
     {
         std::cout << i << "|";
-        for (int j = 0; j < BOARD_SIZE; j++)
+        for (int j = 0; j < N; j++)
         {
             if (_board[i][j] == Stone::Empty)
             {
@@ -343,16 +576,17 @@ void GoGame::showBoard() const
         }
         std::cout << "|" << std::endl;
     }
-    std::cout << "  " << std::string(BOARD_SIZE * 2, '=') << std::endl;
+    std::cout << "  " << std::string(N * 2, '=') << std::endl;
 }
 
-void GoGame::showLiberties() const
+template<int N>
+void BasicGoGame<N>::showLiberties() const
 {
     std::cout << "Liberties:" << std::endl;
-    std::cout << std::string(BOARD_SIZE * 2, '=') << std::endl;
-    for (int i = 0; i < BOARD_SIZE; i++)
+    std::cout << std::string(N * 2, '=') << std::endl;
+    for (int i = 0; i < N; i++)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        for (int j = 0; j < N; j++)
         {
             auto lNum = _pieceGroupMap.getLibertyNum(i, j);
             if (lNum < 0)
@@ -362,15 +596,16 @@ void GoGame::showLiberties() const
         }
         std::cout << std::endl;
     }
-    std::cout << std::string(BOARD_SIZE * 2, '=') << std::endl;
+    std::cout << std::string(N * 2, '=') << std::endl;
 }
 
-Player GoGame::judgeWinner(bool isPrint) const
+template<int N>
+Player BasicGoGame<N>::judgeWinner(bool isPrint) const
 {
     float nBlack = 0; float nWhite = KOMI;
-    for (int i = 0; i < BOARD_SIZE; i++)
+    for (int i = 0; i < N; i++)
     {
-        for (int j = 0; j < BOARD_SIZE; j++)
+        for (int j = 0; j < N; j++)
         {
             if (_board[i][j] == Stone::Black) nBlack += 1;
             else if (_board[i][j] == Stone::White) nWhite += 1;
@@ -387,22 +622,86 @@ Player GoGame::judgeWinner(bool isPrint) const
     return winner;
 }
 
-Player GoGame::getNowPiece() const
+template<int N>
+Player BasicGoGame<N>::getNowPiece() const
 {
     return _nowPiece;
 }
 
-Stone GoGame::getStone(int i, int j) const
+template<int N>
+Stone BasicGoGame<N>::getStone(int i, int j) const
 {
     return _board[i][j];
 }
 
-int GoGame::getLibertyNum(int i, int j) const
+template<int N>
+int BasicGoGame<N>::getLibertyNum(int i, int j) const
 {
     return _pieceGroupMap.getLibertyNum(i, j);
 }
 
-int GoGame::getNMove() const
+template<int N>
+int BasicGoGame<N>::getNMove() const
 {
     return _nMove;
-}
\ No newline at end of file
+}
+
+template<int N>
+uint64_t BasicGoGame<N>::hash() const
+{
+    return _hash;
+}
+
+template<int N>
+uint64_t BasicGoGame<N>::positionKey() const
+{
+    // a pass leaves the board unchanged, so the previous board is this one
+    bool lastPass = _historySize > 0 && _history[_historyHead] == _hash;
+    uint64_t state = (static_cast<uint64_t>(_nMove) << 3)
+                   | (static_cast<uint64_t>(_nowPiece == Player::White) << 2)
+                   | (static_cast<uint64_t>(lastPass) << 1)
+                   | static_cast<uint64_t>(_isGameOver);
+    uint64_t key = _hash ^ splitMix64(state);
+    for (auto ban = _koBan; ban; ban &= ban - 1)
+    {
+        // the seeds of the banned points are above the seeds of the state
+        uint64_t point = static_cast<uint64_t>(lowestPoint(ban) + 1) << 40;
+        key ^= splitMix64(point);
+    }
+    return key;
+}
+
+template<int N>
+std::array<uint64_t, SYMMETRY_NUM> BasicGoGame<N>::symmetricHashes() const
+{
+    std::array<uint64_t, SYMMETRY_NUM> hashes{};
+    for (int i = 0; i < N; i++)
+    {
+        for (int j = 0; j < N; j++)
+        {
+            if (_board[i][j] == Stone::Empty) continue;
+            const auto& keys = SYMMETRIC_ZOBRIST_TABLE<N>[static_cast<int>(_board[i][j]) - 1][i * N + j];
+            for (int t = 0; t < SYMMETRY_NUM; t++)
+            {
+                hashes[t] ^= keys[t];
+            }
+        }
+    }
+    return hashes;
+}
+
+template<int N>
+CanonicalHash BasicGoGame<N>::canonicalHash() const
+{
+    auto hashes = symmetricHashes();
+    CanonicalHash canonical{hashes[0], 0};
+    for (int t = 1; t < SYMMETRY_NUM; t++)
+    {
+        if (hashes[t] < canonical.hash) canonical = {hashes[t], t};
+    }
+    return canonical;
+}
+
+template class BasicGoGame<5>;
+template class BasicGoGame<7>;
+template class BasicGoGame<9>;
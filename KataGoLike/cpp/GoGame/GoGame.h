@@ -2,12 +2,17 @@
 
 #include <array>
 #include <vector>
-#include <set>
-#include <map>
 #include <iostream>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+#include <utility>
 
 #include "../constant.h"
-#include "../utils/BoardMap.hpp"
+#include "../utils/BitMask.hpp"
+#include "../utils/Zobrist.hpp"
+#include "../utils/Symmetry.hpp"
+#include "../utils/FixedVector.hpp"
 
 // Define the Stone and Player enum classes.
 enum class Stone
@@ -23,22 +28,77 @@ enum class Player
 };
 
 // Define the Board and Point types.
-typedef std::array<std::array<Stone, BOARD_SIZE>, BOARD_SIZE> Board;
+template<int N>
+using BasicBoard = std::array<std::array<Stone, N>, N>;
+typedef BasicBoard<BOARD_SIZE> Board;
 typedef std::pair<int, int> Point;
 
+// The neighbors of a point, at most 4.
+typedef FixedVector<Point, 4> Neighbors;
+// A list of moves of a position, every point and pass.
+template<int N>
+using BasicMoveList = FixedVector<Point, N * N + 1>;
+typedef BasicMoveList<BOARD_SIZE> MoveList;
+
+/**
+ * @brief Get the k-th neighbor of a point, in the order of up, down, left, right.
+ * @param index: the index of the point, i * N + j.
+ * @param k: the index of the neighbor.
+ * @return Point: the neighbor, {-1, -1} if the point has no k-th neighbor.
+ */
+template<int N>
+constexpr Point kthNeighbor(int index, int k)
+{
+    int i = index / N; int j = index % N;
+    if (i - 1 >= 0 && k-- == 0) return {i - 1, j};
+    if (i + 1 < N  && k-- == 0) return {i + 1, j};
+    if (j - 1 >= 0 && k-- == 0) return {i, j - 1};
+    if (j + 1 < N  && k-- == 0) return {i, j + 1};
+    return {-1, -1};
+}
+
+template<int N>
+constexpr Neighbors makeNeighbors(int index)
+{
+    std::size_t size = 0;
+    while (size < 4 && kthNeighbor<N>(index, size).first != -1) size++;
+    return Neighbors({kthNeighbor<N>(index, 0), kthNeighbor<N>(index, 1), kthNeighbor<N>(index, 2), kthNeighbor<N>(index, 3)}, size);
+}
+
+template<int N, std::size_t... I>
+constexpr std::array<Neighbors, sizeof...(I)> makeNeighborTable(std::index_sequence<I...>)
+{
+    return {makeNeighbors<N>(I)...};
+}
+
+// The neighbors of every point, NEIGHBOR_TABLE<N>[i * N + j] is the neighbors of (i, j).
+template<int N>
+inline constexpr std::array<Neighbors, N * N> NEIGHBOR_TABLE =
+    makeNeighborTable<N>(std::make_index_sequence<N * N>{});
+
 /**
  * @brief Convert a point on the board into an integer index.
  * @param p: the pair of integers.
  * @return int: the integer index.
  */
-int boardPairToInt(Point p);
+template<int N = BOARD_SIZE>
+constexpr int boardPairToInt(Point p)
+{
+    if (p.first == -1 && p.second == -1) return -1;
+    return p.first * N + p.second;
+}
 
 /**
  * @brief Convert an integer index into a point on the board.
  * @param i: the integer index.
  * @return Point: the pair of integers.
  */
-Point boardIntToPair(int i);
+template<int N = BOARD_SIZE>
+constexpr Point boardIntToPair(int i)
+{
+    if (i == -1) return {-1, -1};
+    return {i / N, i % N};
+}
 
 /**
  * @brief The GoGame class.
@@ -46,9 +106,16 @@ Point boardIntToPair(int i);
  * This class is used to save the state of the game and help with following tasks, including:
  * 1. get some features of the board, such as the neighbors of a point, the possible placements of the next stone, etc.
  * 2. judge the game state, such as whether a placement is legal, whether the game is over, etc.
+ *
+ * The class is a template on the board size N, GoGame is the class of BOARD_SIZE.
  */
-class GoGame
+template<int N>
+class BasicGoGame
 {
+    public:
+        typedef BasicBoardMask<N> BoardMask;
+        typedef BasicMoveList<N>  MoveList;
+
     private:
         /**
          * @brief The PieceGroupMap class.
@@ -59,19 +126,31 @@ class GoGame
          * 2. get the liberties of a specific group of stones.
          *
          * This class borrows the idea from Find-Union Set:
-         * 1. Find: _parent[i][j] is the parent of the stone at (i, j).
+         * 1. Find: _parent[i * N + j] is the parent of the stone at (i, j).
          * 2. Union: merge function is used to merge two groups of stones.
          * https://en.wikipedia.org/wiki/Disjoint-set_data_structure
+         *
+         * The stones and liberties of a group are saved as BoardMasks of its parent,
+         * so the class has a fixed size and is trivially copyable.
          */
         class PieceGroupMap
         {
             private:
-                // The parent of each stone, {-1, -1} means the stone is not in any group.
-                BoardMap<Point>                         _parent    = {};
+                // The index of no parent.
+                static constexpr uint8_t NO_PARENT = 0xFF;
+                // The parent of each stone, NO_PARENT means the stone is not in any group.
+                std::array<uint8_t, N * N>   _parent    = makeEmptyParent();
                 // The children of parents.
-                BoardMap<std::set<std::pair<int, int>>> _children  = {};
+                std::array<BoardMask, N * N> _children  = {};
                 // The liberties of parents.
-                BoardMap<std::set<std::pair<int, int>>> _liberties = {};
+                std::array<BoardMask, N * N> _liberties = {};
+
+                static constexpr std::array<uint8_t, N * N> makeEmptyParent()
+                {
+                    std::array<uint8_t, N * N> parent{};
+                    for (auto& p : parent) p = NO_PARENT;
+                    return parent;
+                }
             public:
                 PieceGroupMap()                                    = default;
                 PieceGroupMap(const PieceGroupMap& map)            = default;
@@ -134,8 +213,39 @@ class GoGame
                  * @brief get the stones of a group with a specific stone.
                  * @param i: the row index of the stone.
                  * @param j: the column index of the stone.
+                 * @return BoardMask: the stones of the group.
                 */
-                const std::set<std::pair<int, int>>& getChildren(int i, int j) const;
+                BoardMask getChildren(int i, int j) const;
+
+                /**
+                 * @brief get the liberties of a group with a specific stone.
+                 * @param i: the row index of the stone.
+                 * @param j: the column index of the stone.
+                 * @return BoardMask: the liberties of the group.
+                */
+                BoardMask getLiberties(int i, int j) const;
+
+                /**
+                 * @brief remove liberties from a group of stones with a specific stone.
+                 * @param i: the row index of the stone.
+                 * @param j: the column index of the stone.
+                 * @param liberties: the liberties to be removed.
+                 */
+                void removeLiberties(int i, int j, BoardMask liberties);
+
+                /**
+                 * @brief Save a group of stones, the stones of the group must not be in any other group.
+                 * @param children: the stones of the group.
+                 * @param liberties: the liberties of the group.
+                 */
+                void setGroup(BoardMask children, BoardMask liberties);
+
+                /**
+                 * @brief Remove a single stone from the map, the group of the stone is not updated.
+                 * @param i: the row index of the stone.
+                 * @param j: the column index of the stone.
+                 */
+                void removeStone(int i, int j);
 
                 /**
                  * @brief Remove a group of stones with a specific stone.
@@ -148,25 +258,92 @@ class GoGame
         // The map of groups of stones.
         PieceGroupMap _pieceGroupMap = {};
         // The board of the game.
-        Board         _board;
-        // The previous board of the game.
-        Board         _previousBoard;
+        BasicBoard<N> _board;
+        // The Zobrist hash of the board.
+        uint64_t      _hash          = 0;
+        // The hashes of the previous boards, a ring buffer, _history[_historyHead] is the previous board.
+        std::array<uint64_t, KO_HISTORY_SIZE> _history = {};
+        // The index of the previous board in _history.
+        int           _historyHead   = 0;
+        // The number of valid hashes in _history.
+        int           _historySize   = 0;
         // Now piece to move.
         Player        _nowPiece      = Player::Black;
         // The number of moves which have been made.
         int           _nMove         = 0;
         // is the game over.
         bool          _isGameOver    = false;
+        // The points where black and white can place a stone, the KO rule is not checked.
+        std::array<BoardMask, 2> _legalMask = {FULL_MASK<N>, FULL_MASK<N>};
+        // The points where now piece can not place a stone because of the KO rule.
+        BoardMask     _koBan         = 0;
         // The maximum number of moves that can be made.
-        static const int _maxMove = BOARD_SIZE * BOARD_SIZE - 1;
+        static constexpr int _maxMove = N * N - 1;
+
+        /**
+         * @brief Save the hash of a board as the previous board.
+         * @param hash: the hash of the board.
+         */
+        void pushHistory(uint64_t hash);
+
+        /**
+         * @brief Check whether a hash is one of the previous boards.
+         * @param hash: the hash of the board.
+         * @return bool: whether the board has appeared.
+         */
+        bool isRepetition(uint64_t hash) const;
+
+        /**
+         * @brief Get the hash of the board after a placement, including the captures.
+         * @param i: the row index of the placement.
+         * @param j: the column index of the placement.
+         * @param stone: the stone to be placed.
+         * @return uint64_t: the hash of the board after the placement.
+         */
+        uint64_t hashAfterPlacement(int i, int j, Stone stone) const;
+
+        /**
+         * @brief Update _legalMask of both colors on some points, the KO rule is not checked.
+         * @param points: the points to be updated.
+         */
+        void updateLegalMask(BoardMask points);
+
+        /**
+         * @brief Update _koBan, only the candidates can be banned.
+         * @param candidates: the points which may be banned by the KO rule.
+         */
+        void updateKoBan(BoardMask candidates);
 
     public:
-        GoGame();
-        GoGame(const GoGame& game)            = default;
-        GoGame(GoGame&& game)                 = default;
-        GoGame& operator=(const GoGame& game) = default;
-        GoGame& operator=(GoGame&& game)      = default;
-        ~GoGame()                             = default;
+        /**
+         * @brief The UndoRecord struct.
+         * 
+         * Everything makeMove changes and can not derive back, undoMove uses it to restore the game.
+         */
+        struct UndoRecord
+        {
+            // The move which has been made, {-1, -1} for pass.
+            Point     move               = {-1, -1};
+            // The stones captured by the move.
+            BoardMask captured           = 0;
+            // The hash of the board before the move.
+            uint64_t  hash               = 0;
+            // The hash in _history overwritten by the move.
+            uint64_t  overwrittenHistory = 0;
+            // The number of valid hashes in _history before the move.
+            int       historySize        = 0;
+            // The legal masks before the move.
+            std::array<BoardMask, 2> legalMask = {};
+            // The KO ban before the move.
+            BoardMask koBan              = 0;
+        };
+
+        BasicGoGame();
+        BasicGoGame(const BasicGoGame& game)            = default;
+        BasicGoGame(BasicGoGame&& game)                 = default;
+        BasicGoGame& operator=(const BasicGoGame& game) = default;
+        BasicGoGame& operator=(BasicGoGame&& game)      = default;
+        ~BasicGoGame()                                  = default;
 
         /**
          * @brief Construct a new GoGame object, copy the board, previous board and now piece given by python.
@@ -175,15 +352,15 @@ class GoGame
          * @param nowPiece: the piece that should be placed. 1 for black, 2 for white.
          * @param nMove: the number of moves which have been made. -1 for not given.
          */
-        GoGame(int* board, int* previousBoard, int nowPiece, int nMove = -1);
+        BasicGoGame(int* board, int* previousBoard, int nowPiece, int nMove = -1);
 
         /**
          * @brief Get the neighbors of a point.
          * @param i: the row index of the point.
          * @param j: the column index of the point.
-         * @return std::vector<Point>: the neighbors of the point.
+         * @return const Neighbors&: the neighbors of the point.
          */
-        std::vector<Point> getNeighbors(int i, int j) const;
+        const Neighbors& getNeighbors(int i, int j) const;
 
         /**
          * @brief Check whether a placement is legal.
@@ -194,11 +371,17 @@ class GoGame
         */
         bool isLegal(int i, int j, Stone stone) const;
 
+        /**
+         * @brief Get the points where now piece can place a stone, it is updated by every move.
+         * @return BoardMask: the legal points, the same as isLegal on every point.
+         */
+        BoardMask getLegalMask() const;
+
         /**
          * @brief Get the possible placements of the next stone.
-         * @return std::vector<Point>: the possible placements.
+         * @return MoveList: the possible placements.
          */
-        std::vector<Point> getPossiblePlacements() const;
+        MoveList getPossiblePlacements() const;
 
         /**
          * @brief place a stone on the board.
@@ -211,8 +394,9 @@ class GoGame
          * @param i: the row index of the stone has been placed.
          * @param j: the column index of the stone has been placed.
          * @param stone: the stone has been placed.
+         * @return BoardMask: the stones which have been removed.
          */
-        void removeNeighborGroups(int i, int j, Stone stone);
+        BoardMask removeNeighborGroups(int i, int j, Stone stone);
 
         /**
          * @brief Remove a group of stones.
@@ -229,6 +413,21 @@ class GoGame
          */
         bool move(int i, int j);
 
+        /**
+         * @brief Move a move, and save what is needed to undo it.
+         * @param i: the row index of the placement.
+         * @param j: the column index of the placement.
+         * @param record: the record to be filled, only valid if the move is successful.
+         * @return bool: whether the move is successful.
+         */
+        bool makeMove(int i, int j, UndoRecord& record);
+
+        /**
+         * @brief Undo the last successful makeMove, records must be undone in the reverse order.
+         * @param record: the record filled by makeMove.
+         */
+        void undoMove(const UndoRecord& record);
+
         /**
          * @brief Show the board.
          */
@@ -279,4 +478,38 @@ class GoGame
          * @return int: the number of moves which have been made.
         */
         int getNMove() const;
-};
\ No newline at end of file
+
+        /**
+         * @brief Get the Zobrist hash of the board, can be used as the key of the position.
+         * @return uint64_t: the hash of the board.
+        */
+        uint64_t hash() const;
+
+        /**
+         * @brief Get the key of the position for transpositions, games with the same key have the same future.
+         * Besides the stones, the piece to move, the number of moves, the KO ban, whether the last move is a pass
+         * and whether the game is over are hashed. The history of the superko is not.
+         * @return uint64_t: the key of the position.
+        */
+        uint64_t positionKey() const;
+
+        /**
+         * @brief Get the Zobrist hashes of the 8 transforms of the board, see utils/Symmetry.hpp.
+         * @return std::array<uint64_t, SYMMETRY_NUM>: the hash of the board after each transform, the first one is hash().
+        */
+        std::array<uint64_t, SYMMETRY_NUM> symmetricHashes() const;
+
+        /**
+         * @brief Get the canonical hash of the board, symmetric boards have the same canonical hash.
+         * Like hash(), only the stones are hashed, not the piece to move or the KO state.
+         * A move m of this game is transformPoint(m, transform) in the canonical board,
+         * a policy of the canonical board is transformPolicy(policy, inverseTransform(transform)) in this game.
+         * @return CanonicalHash: the smallest hash of the transforms, and the transform.
+        */
+        CanonicalHash canonicalHash() const;
+};
+
+typedef BasicGoGame<BOARD_SIZE> GoGame;
+
+// copying a game is a plain memory copy, searches copy it for every node
+static_assert(std::is_trivially_copyable_v<GoGame>, "GoGame should be trivially copyable");
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+
+#include "NeuralNetworkInferenceEngine.hpp"
+
+/**
+ * @brief An inference engine which batches the requests of several threads.
+ *
+ * The search threads submit single positions, a dispatcher thread collects them into a batch
+ * until the batch is full or the oldest request has waited for the timeout,
+ * then runs the whole batch with one call of the wrapped engine and fulfils the futures.
+ * The per-call overhead of the wrapped engine is shared by the batch.
+ * The value of a position is carried with its policy when the wrapped engine has a value output.
+ * The class is a template on the board size N, BatchInferenceEngine is the class of BOARD_SIZE.
+ */
+template<int N>
+class BasicBatchInferenceEngine : public BasicNeuralNetworkInferenceEngine<N>
+{
+public:
+    /**
+     * @brief Constructs a BatchInferenceEngine and starts its dispatcher thread.
+     *
+     * @param engine The engine which runs the batches.
+     * @param maxBatchSize The maximum number of positions in a batch.
+     * @param timeout The longest time a request waits for the batch to be filled.
+     */
+    BasicBatchInferenceEngine(std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>>&& engine,
+                              std::size_t maxBatchSize = DEFAULT_MAX_BATCH_SIZE,
+                              std::chrono::microseconds timeout = std::chrono::microseconds(DEFAULT_BATCH_TIMEOUT_US))
+        : _engine(std::move(engine)), _maxBatchSize(std::max<std::size_t>(maxBatchSize, 1)), _timeout(timeout)
+    {
+        _dispatcher = std::thread(&BasicBatchInferenceEngine::dispatch, this);
+    }
+    BasicBatchInferenceEngine(const BasicBatchInferenceEngine&) = delete;
+    BasicBatchInferenceEngine& operator=(const BasicBatchInferenceEngine&) = delete;
+
+    ~BasicBatchInferenceEngine() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        _dispatcher.join();
+    }
+
+    // The policy and the value of a position, the value is 0 if the wrapped engine has no value output.
+    typedef std::pair<BasicOutputArray<N>, float> Evaluation;
+
+    /**
+     * @brief Submit a position, it is evaluated in the next batch.
+     *
+     * @param input The input data of the position.
+     * @return std::future<Evaluation> The policy and the value of the position.
+     */
+    std::future<Evaluation> submit(const BasicInputArray<N>& input)
+    {
+        Request request{input, {}, std::chrono::steady_clock::now()};
+        auto future = request.promise.get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _requests.push_back(std::move(request));
+        }
+        _condition.notify_one();
+        return future;
+    }
+
+    /**
+     * @brief Performs inference, a single position goes through the batch, a batch is run directly.
+     *
+     * @param input The input data for inference.
+     * @param output The policy net output.
+     * @param batchSize The size of the batch for inference.
+     */
+    void inference(float* input, float* output, std::size_t batchSize) override
+    {
+        if (batchSize != 1)
+        {
+            _engine->inference(input, output, batchSize);
+            return;
+        }
+        auto result = submit(*reinterpret_cast<const BasicInputArray<N>*>(input)).get();
+        std::copy(result.first.begin(), result.first.end(), output);
+    }
+
+    /**
+     * @brief Performs inference with value, a single position goes through the batch, a batch is run directly.
+     *
+     * @param input The input data for inference.
+     * @param output The policy net output.
+     * @param value The value output, not written if the wrapped engine has no value output.
+     * @param batchSize The size of the batch for inference.
+     */
+    void inference(float* input, float* output, float* value, std::size_t batchSize) override
+    {
+        if (batchSize != 1)
+        {
+            _engine->inference(input, output, value, batchSize);
+            return;
+        }
+        auto result = submit(*reinterpret_cast<const BasicInputArray<N>*>(input)).get();
+        std::copy(result.first.begin(), result.first.end(), output);
+        if (hasValue()) *value = result.second;
+    }
+
+    bool hasValue() const override
+    {
+        return _engine->hasValue();
+    }
+
+private:
+    struct Request
+    {
+        BasicInputArray<N>                    input;
+        std::promise<Evaluation>              promise;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    std::unique_ptr<BasicNeuralNetworkInferenceEngine<N>> _engine;
+    std::size_t                 _maxBatchSize;
+    std::chrono::microseconds   _timeout;
+    std::deque<Request>         _requests{};
+    std::mutex                  _mutex{};
+    std::condition_variable     _condition{};
+    bool                        _stop = false;
+    std::thread                 _dispatcher;
+
+    // The loop of the dispatcher thread.
+    void dispatch()
+    {
+        std::vector<Request>             batch;
+        std::vector<BasicInputArray<N>>  inputs;
+        std::vector<BasicOutputArray<N>> outputs;
+        std::vector<float>               values;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this]() { return _stop || !_requests.empty(); });
+                if (_requests.empty()) return;
+
+                // wait for more requests until the batch is full or the oldest request times out
+                auto deadline = _requests.front().time + _timeout;
+                _condition.wait_until(lock, deadline, [this]() { return _stop || _requests.size() >= _maxBatchSize; });
+
+                auto size = std::min(_requests.size(), _maxBatchSize);
+                batch.clear();
+                for (std::size_t i = 0; i < size; i++)
+                {
+                    batch.push_back(std::move(_requests.front()));
+                    _requests.pop_front();
+                }
+            }
+
+            inputs.resize(batch.size());
+            outputs.resize(batch.size());
+            values.assign(batch.size(), 0.0f);
+            for (std::size_t i = 0; i < batch.size(); i++)
+            {
+                inputs[i] = batch[i].input;
+            }
+            try
+            {
+                _engine->inference(inputs, outputs, values);
+                for (std::size_t i = 0; i < batch.size(); i++)
+                {
+                    batch[i].promise.set_value({outputs[i], values[i]});
+                }
+            }
+            catch (...)
+            {
+                for (auto& request : batch)
+                {
+                    request.promise.set_exception(std::current_exception());
+                }
+            }
+        }
+    }
+};
+
+typedef BasicBatchInferenceEngine<BOARD_SIZE> BatchInferenceEngine;
@@ -13,8 +13,10 @@
  *
  * This class provides an interface for performing inference on input data and obtaining output predictions.
  * It also defines constants related to the model's configuration.
+ * The class is a template on the board size N, NeuralNetworkInferenceEngine is the class of BOARD_SIZE.
  */
-class NeuralNetworkInferenceEngine
+template<int N>
+class BasicNeuralNetworkInferenceEngine
 {
 public:
     /**
@@ -28,6 +30,31 @@ public:
      */
     virtual void inference(float *input, float *output, std::size_t batchSize) = 0;
 
+    /**
+     * @brief Perform inference using the given input, and also get the value prediction if the model has a value output.
+     *
+     * The default implementation is for models without a value output, the value is not written.
+     *
+     * @param input The input data for inference.
+     * @param output The first output prediction, policy net output.
+     * @param value The second output prediction, batchSize win rates of the player to move, in [0, 1].
+     * @param batchSize The size of the input batch.
+     */
+    virtual void inference(float *input, float *output, [[maybe_unused]] float *value, std::size_t batchSize)
+    {
+        inference(input, output, batchSize);
+    }
+
+    /**
+     * @brief Whether the model has a value output.
+     *
+     * @return bool True if inference with value writes the value.
+     */
+    virtual bool hasValue() const
+    {
+        return false;
+    }
+
     /**
      * @brief Perform inference using the given input and store the results in the output arrays.
      *
@@ -35,15 +62,15 @@ public:
      * It accepts input and output arrays with fixed sizes and delegates the actual inference to the `inference` method.
      *
      * @tparam batchSize The size of the input batch.
-     * @tparam N The size of the first output prediction, N must be equal to batchSize.
+     * @tparam M The size of the first output prediction, M must be equal to batchSize.
      * @param input The input data for inference.
      * @param output The first output prediction, policy net output.
      */
-    template <std::size_t batchSize, std::size_t N>
-    void inference(const float (&input)[batchSize][NUMBER_OF_INPUT_CHANNELS][BOARD_SIZE][BOARD_SIZE], 
-                   float (&output)[N][BOARD_SIZE * BOARD_SIZE + 1])
+    template <std::size_t batchSize, std::size_t M>
+    void inference(const float (&input)[batchSize][NUMBER_OF_INPUT_CHANNELS][N][N], 
+                   float (&output)[M][N * N + 1])
     {
-        static_assert(batchSize == N, "batch size of input and outputs must be the same");
+        static_assert(batchSize == M, "batch size of input and outputs must be the same");
         inference((float *)&input, (float *)&output, batchSize);
     }
     
@@ -54,15 +81,15 @@ public:
      * It accepts input and output arrays with fixed sizes and delegates the actual inference to the `inference` method.
      * 
      * @tparam batchSize The batch size of the input data.
-     * @tparam N The size of the first output array, N must be equal to batchSize.
+     * @tparam M The size of the first output array, M must be equal to batchSize.
      * @param input The input data for inference.
      * @param output The first output prediction, policy net output.
      */
-    template <std::size_t batchSize, std::size_t N>
-    void inference(const std::array<InputArray, batchSize>& input, 
-                   std::array<OutputArray, N>& output)
+    template <std::size_t batchSize, std::size_t M>
+    void inference(const std::array<BasicInputArray<N>, batchSize>& input, 
+                   std::array<BasicOutputArray<N>, M>& output)
     {
-        static_assert(batchSize == N, "batch size of input and outputs must be the same");
+        static_assert(batchSize == M, "batch size of input and outputs must be the same");
         inference((float *)input.data(), (float *)output.data(), batchSize);
     }
 
@@ -75,11 +102,25 @@ public:
      * @param input The input data for inference.
      * @param output The first output prediction, policy net output.
      */
-    void inference(const std::vector<InputArray>& input, std::vector<OutputArray>& output)
+    void inference(const std::vector<BasicInputArray<N>>& input, std::vector<BasicOutputArray<N>>& output)
     {
         inference((float *)input.data(), (float *)output.data(), input.size());
     }
 
+    /**
+     * @brief Perform inference using the given input and store the results and the values in the output arrays.
+     *
+     * This method is a convenience wrapper around the virtual `inference` method with value.
+     *
+     * @param input The input data for inference.
+     * @param output The first output prediction, policy net output.
+     * @param value The second output prediction, not written if the model has no value output.
+     */
+    void inference(const std::vector<BasicInputArray<N>>& input, std::vector<BasicOutputArray<N>>& output, std::vector<float>& value)
+    {
+        inference((float *)input.data(), (float *)output.data(), value.data(), input.size());
+    }
+
     /**
      * @brief Perform inference using the given input and store the results in the output arrays.
      * 
@@ -89,7 +130,7 @@ public:
      * @param input The input data for inference.
      * @param output The first output prediction, policy net output.
      */
-    void inference(const InputArray& input, OutputArray& output)
+    void inference(const BasicInputArray<N>& input, BasicOutputArray<N>& output)
     {
         inference((float *)input.data(), (float *)output.data(), 1);
     }
@@ -103,11 +144,13 @@ public:
      * @param input The input data for inference.
      * @param output The first output prediction, policy net output.
      */
-    void inference(const float (&input)[NUMBER_OF_INPUT_CHANNELS][BOARD_SIZE][BOARD_SIZE], 
-                   float (&output)[BOARD_SIZE * BOARD_SIZE + 1])
+    void inference(const float (&input)[NUMBER_OF_INPUT_CHANNELS][N][N], 
+                   float (&output)[N * N + 1])
     {
         inference((float *)&input, (float *)&output, 1);
     }
 
-    virtual ~NeuralNetworkInferenceEngine() = default;
-};
\ No newline at end of file
+    virtual ~BasicNeuralNetworkInferenceEngine() = default;
+};
+
+typedef BasicNeuralNetworkInferenceEngine<BOARD_SIZE> NeuralNetworkInferenceEngine;
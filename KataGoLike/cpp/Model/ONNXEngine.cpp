@@ -1,8 +1,10 @@
 #include <algorithm>
+#include <string>
 
 #include "ONNXEngine.h"
 
-ONNXEngine::ONNXEngine(const char *onnxModelPath, unsigned int threadNum)
+template<int N>
+BasicONNXEngine<N>::BasicONNXEngine(const char *onnxModelPath, unsigned int threadNum)
 {
     _env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING,"MyOnnxRuntimeModel");
     Ort::SessionOptions sessionOptions{};
@@ -16,17 +18,27 @@ ONNXEngine::ONNXEngine(const char *onnxModelPath, unsigned int threadNum)
     _session = std::make_unique<Ort::Session>(*_env, onnxModelPath, sessionOptions);
     _memoryInfo = std::make_unique<Ort::MemoryInfo>(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault));
     _runOptions = std::make_unique<Ort::RunOptions>();
+    // old models only have the policy output, other outputs such as an ownership head are not used
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0; i < _session->GetOutputCount(); i++)
+    {
+        if (std::string(_session->GetOutputNameAllocated(i, allocator).get()) == OUTPUT_NAMES[1])
+            _hasValue = true;
+    }
 }
 
-ONNXEngine::ONNXEngine(ONNXEngine&& other) noexcept
+template<int N>
+BasicONNXEngine<N>::BasicONNXEngine(BasicONNXEngine&& other) noexcept
 {
     _env = std::move(other._env);
     _session = std::move(other._session);
     _memoryInfo = std::move(other._memoryInfo);
     _runOptions = std::move(other._runOptions);
+    _hasValue = other._hasValue;
 }
 
-ONNXEngine& ONNXEngine::operator=(ONNXEngine&& other) noexcept
+template<int N>
+BasicONNXEngine<N>& BasicONNXEngine<N>::operator=(BasicONNXEngine&& other) noexcept
 {
     if(this != &other) 
     {
@@ -34,20 +46,42 @@ ONNXEngine& ONNXEngine::operator=(ONNXEngine&& other) noexcept
         _session = std::move(other._session);
         _memoryInfo = std::move(other._memoryInfo);
         _runOptions = std::move(other._runOptions);
+        _hasValue = other._hasValue;
     }
     return *this;
 }
 
-void ONNXEngine::inference(float *input, float *output, size_t batchSize)
+template<int N>
+void BasicONNXEngine<N>::inference(float *input, float *output, size_t batchSize)
+{
+    inference(input, output, nullptr, batchSize);
+}
+
+template<int N>
+bool BasicONNXEngine<N>::hasValue() const
 {
-    _inputSize[0] = batchSize;
+    return _hasValue;
+}
+
+template<int N>
+void BasicONNXEngine<N>::inference(float *input, float *output, float *value, size_t batchSize)
+{
+    // the shape is local, so the inference can be called by several search threads at the same time
+    int64_t inputSize[4] = {static_cast<int64_t>(batchSize), NUMBER_OF_INPUT_CHANNELS, N, N};
     // Create input tensor, and copy input data to it
     Ort::Value inputTensor = 
         Ort::Value::CreateTensor<float>(*_memoryInfo, input, 
-                                        batchSize*NUMBER_OF_INPUT_CHANNELS*BOARD_SIZE*BOARD_SIZE, 
-                                        (int64_t*)_inputSize, 4);
-    // Run inference
-    auto result = _session->Run(*_runOptions, INPUT_NAMES, &inputTensor, 1, OUTPUT_NAMES, 1);
+                                        batchSize*NUMBER_OF_INPUT_CHANNELS*N*N, 
+                                        inputSize, 4);
+    // Run inference, the value is only computed when it is asked for
+    bool withValue = _hasValue && value != nullptr;
+    auto result = _session->Run(*_runOptions, INPUT_NAMES, &inputTensor, 1, OUTPUT_NAMES, withValue ? 2 : 1);
     // Copy output data to output arrays
-    std::copy_n(result[0].GetTensorMutableData<float>(), batchSize*(BOARD_SIZE*BOARD_SIZE + 1), (float*)output);
+    std::copy_n(result[0].GetTensorMutableData<float>(), batchSize*(N*N + 1), (float*)output);
+    if (withValue)
+        std::copy_n(result[1].GetTensorMutableData<float>(), batchSize, value);
 }
+
+template class BasicONNXEngine<5>;
+template class BasicONNXEngine<7>;
+template class BasicONNXEngine<9>;
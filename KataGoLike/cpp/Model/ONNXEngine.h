@@ -8,20 +8,22 @@
  * @brief A class that represents a TensorRT model for the AI.
  * 
  * This class inherits from the base Model class and provides functionality to use onnxruntime to inference.
+ * The class is a template on the board size N, ONNXEngine is the class of BOARD_SIZE.
  */
-class ONNXEngine : public NeuralNetworkInferenceEngine{
+template<int N>
+class BasicONNXEngine : public BasicNeuralNetworkInferenceEngine<N>{
 public:
     /**
      * @brief Constructs a ONNXEngine object with the specified ONNX model path.
      * 
      * @param onnxModelPath The path to the ONNX model file.
      */
-    explicit ONNXEngine(const char *onnxModelPath, unsigned int threadNum = DEFAULT_NUM_OF_INFERENCE_THREAD);
-    ONNXEngine() = delete;
-    ONNXEngine(ONNXEngine&& other) noexcept;
-    ONNXEngine& operator=(ONNXEngine&& other) noexcept;
-    ONNXEngine(const ONNXEngine&) = delete;
-    ONNXEngine& operator=(const ONNXEngine&) = delete;
+    explicit BasicONNXEngine(const char *onnxModelPath, unsigned int threadNum = DEFAULT_NUM_OF_INFERENCE_THREAD);
+    BasicONNXEngine() = delete;
+    BasicONNXEngine(BasicONNXEngine&& other) noexcept;
+    BasicONNXEngine& operator=(BasicONNXEngine&& other) noexcept;
+    BasicONNXEngine(const BasicONNXEngine&) = delete;
+    BasicONNXEngine& operator=(const BasicONNXEngine&) = delete;
 
     /**
      * @brief Performs inference using the ONNX model.
@@ -33,10 +35,27 @@ public:
      */
     void inference(float* input, float* output, size_t batchSize) override;
 
+    /**
+     * @brief Performs inference using the ONNX model, and gets the value if the model has a value output.
+     * 
+     * @param input The input data for inference.
+     * @param output The policy output of the inference.
+     * @param value The value output of the inference, not written if the model has no value output.
+     * @param batchSize The size of the batch for inference.
+     */
+    void inference(float* input, float* output, float* value, size_t batchSize) override;
+
+    /**
+     * @brief Whether the ONNX model has a second output, the value.
+     */
+    bool hasValue() const override;
+
 private:
     std::unique_ptr<Ort::Env> _env;
     std::unique_ptr<Ort::Session> _session;
     std::unique_ptr<Ort::MemoryInfo> _memoryInfo;
     std::unique_ptr<Ort::RunOptions> _runOptions;
-    int64_t _inputSize[4] = {0, NUMBER_OF_INPUT_CHANNELS, BOARD_SIZE, BOARD_SIZE};
+    bool _hasValue = false;
 };
+
+typedef BasicONNXEngine<BOARD_SIZE> ONNXEngine;
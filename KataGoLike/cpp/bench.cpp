@@ -0,0 +1,387 @@
+#include<iostream>
+#include<iomanip>
+#include<chrono>
+#include<random>
+#include<string>
+#include<array>
+
+#include "GoGame/GoGame.h"
+#include "GoGame/BitboardGoGame.h"
+#include "AI/EvaluationCache.hpp"
+
+constexpr int DEFAULT_BENCH_GAMES = 20000;
+constexpr unsigned int BENCH_SEED = 20240403;
+
+struct BenchResult
+{
+    long long          nMove    = 0;
+    double             seconds  = 0;
+    unsigned long long checksum = 0;
+};
+
+/**
+ * @brief Play random games from the empty board, the same way as a search does:
+ *        every ply copies the game, asks for the possible placements and moves.
+ * @param nGames: the number of games to play.
+ * @return BenchResult: the number of moves, the time used and a checksum of the final boards.
+ */
+template<class Game>
+BenchResult playRandomGames(int nGames)
+{
+    using namespace std::chrono;
+
+    BenchResult result{};
+    std::mt19937 gen(BENCH_SEED);
+    auto startTime = steady_clock::now();
+
+    for (int n = 0; n < nGames; n++)
+    {
+        Game game = Game();
+        while (!game.isGameOver())
+        {
+            auto moves = game.getPossiblePlacements();
+            // the last index is pass
+            std::uniform_int_distribution<> distribution(0, moves.size());
+            auto index = distribution(gen);
+            auto [i, j] = (index == (int)moves.size()) ? std::make_pair(-1, -1) : moves[index];
+
+            Game next = game;
+            if (!next.move(i, j)) break;
+            game = next;
+            result.nMove += 1;
+        }
+
+        for (int i = 0; i < BOARD_SIZE; i++)
+        {
+            for (int j = 0; j < BOARD_SIZE; j++)
+            {
+                result.checksum = result.checksum * 3 + static_cast<int>(game.getStone(i, j));
+            }
+        }
+        result.checksum = result.checksum * 31 + game.getNMove();
+    }
+
+    result.seconds = duration<double>(steady_clock::now() - startTime).count();
+    return result;
+}
+
+/**
+ * @brief Expand a midgame position the same way as MCTNode::expand does:
+ *        every child copies the parent game and moves, the pass child included.
+ * @param nExpand: the number of expansions.
+ * @return BenchResult: the number of children, the time used and a checksum of the children.
+ */
+template<class Game>
+BenchResult expandMidgame(int nExpand)
+{
+    using namespace std::chrono;
+
+    const std::pair<int, int> opening[] = {{2, 2}, {2, 3}, {1, 2}, {3, 3}, {3, 2}, {1, 3}, {2, 1}, {0, 3}, {1, 1}, {3, 1}};
+    Game parent = Game();
+    for (auto [i, j] : opening) parent.move(i, j);
+
+    BenchResult result{};
+    auto startTime = steady_clock::now();
+
+    for (int n = 0; n < nExpand; n++)
+    {
+        auto moves = parent.getPossiblePlacements();
+        moves.push_back({-1, -1});
+        for (auto [i, j] : moves)
+        {
+            Game child = parent;
+            child.move(i, j);
+            result.checksum += child.getLibertyNum(2, 2) + child.getNMove();
+            result.nMove += 1;
+        }
+    }
+
+    result.seconds = duration<double>(steady_clock::now() - startTime).count();
+    return result;
+}
+
+/**
+ * @brief The same expansion as expandMidgame, but every child is made and undone on the parent game.
+ * @param nExpand: the number of expansions.
+ * @return BenchResult: the number of children, the time used and a checksum of the children.
+ */
+BenchResult expandMidgameInPlace(int nExpand)
+{
+    using namespace std::chrono;
+
+    const std::pair<int, int> opening[] = {{2, 2}, {2, 3}, {1, 2}, {3, 3}, {3, 2}, {1, 3}, {2, 1}, {0, 3}, {1, 1}, {3, 1}};
+    GoGame parent = GoGame();
+    for (auto [i, j] : opening) parent.move(i, j);
+
+    BenchResult result{};
+    auto startTime = steady_clock::now();
+
+    for (int n = 0; n < nExpand; n++)
+    {
+        auto moves = parent.getPossiblePlacements();
+        moves.push_back({-1, -1});
+        for (auto [i, j] : moves)
+        {
+            GoGame::UndoRecord record;
+            parent.makeMove(i, j, record);
+            result.checksum += parent.getLibertyNum(2, 2) + parent.getNMove();
+            result.nMove += 1;
+            parent.undoMove(record);
+        }
+    }
+
+    result.seconds = duration<double>(steady_clock::now() - startTime).count();
+    return result;
+}
+
+/**
+ * @brief Check whether two games are the same through the public API.
+ */
+bool isSameGame(const GoGame& a, const GoGame& b)
+{
+    if (a.hash() != b.hash() || a.getNMove() != b.getNMove() || a.getLegalMask() != b.getLegalMask() ||
+        a.getNowPiece() != b.getNowPiece() || a.isGameOver() != b.isGameOver()) return false;
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            if (a.getStone(i, j) != b.getStone(i, j) || a.getLibertyNum(i, j) != b.getLibertyNum(i, j)) return false;
+            for (auto stone : {Stone::Black, Stone::White})
+            {
+                if (a.isLegal(i, j, stone) != b.isLegal(i, j, stone)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Differential test of makeMove/undoMove against the copy-based move:
+ *        along seeded random games, every child is made on the game and compared with a moved copy,
+ *        then undone and compared with the game before the move.
+ *        The legal mask of every position is also compared with isLegal.
+ * @param nGames: the number of games to play.
+ * @return int: the number of mismatches.
+ */
+int verifyUndo(int nGames)
+{
+    int mismatch = 0;
+    std::mt19937 gen(BENCH_SEED);
+
+    for (int n = 0; n < nGames; n++)
+    {
+        GoGame game = GoGame();
+        while (!game.isGameOver())
+        {
+            auto moves = game.getPossiblePlacements();
+            moves.push_back({-1, -1});
+            const GoGame before = game;
+
+            // the legal mask is updated incrementally, it must be the same as isLegal on every point
+            BoardMask legal = 0;
+            for (int i = 0; i < BOARD_SIZE; i++)
+            {
+                for (int j = 0; j < BOARD_SIZE; j++)
+                {
+                    if (game.isLegal(i, j, static_cast<Stone>(game.getNowPiece()))) legal |= pointMask(i, j);
+                }
+            }
+            if (legal != game.getLegalMask()) mismatch += 1;
+
+            for (auto [i, j] : moves)
+            {
+                GoGame copied = before;
+                GoGame::UndoRecord record;
+                bool copiedResult = copied.move(i, j);
+                bool madeResult   = game.makeMove(i, j, record);
+                if (copiedResult != madeResult || !isSameGame(game, copied)) mismatch += 1;
+                if (madeResult) game.undoMove(record);
+                if (!isSameGame(game, before)) mismatch += 1;
+            }
+
+            std::uniform_int_distribution<> distribution(0, moves.size() - 1);
+            auto [i, j] = moves[distribution(gen)];
+            game.move(i, j);
+        }
+    }
+    return mismatch;
+}
+
+/**
+ * @brief Check the symmetry API along seeded random games:
+ *        every game is also played in its 8 transforms, the transformed games must have the hashes
+ *        given by symmetricHashes, the same canonical hash, and the transformed legal moves.
+ * @param nGames: the number of games to play.
+ * @return int: the number of mismatches.
+ */
+int verifySymmetry(int nGames)
+{
+    int mismatch = 0;
+    std::mt19937 gen(BENCH_SEED);
+
+    for (int n = 0; n < nGames; n++)
+    {
+        GoGame game = GoGame();
+        std::array<GoGame, SYMMETRY_NUM> transformed{};
+        while (!game.isGameOver())
+        {
+            auto hashes    = game.symmetricHashes();
+            auto canonical = game.canonicalHash();
+            auto moves     = game.getPossiblePlacements();
+            for (int t = 0; t < SYMMETRY_NUM; t++)
+            {
+                if (transformed[t].hash() != hashes[t]) mismatch += 1;
+                if (transformed[t].canonicalHash().hash != canonical.hash) mismatch += 1;
+
+                BoardMask legal = 0;
+                for (auto move : moves)
+                {
+                    auto [i, j] = transformPoint(move, t);
+                    legal |= pointMask(i, j);
+                    if (transformPoint(std::make_pair(i, j), inverseTransform(t)) != move) mismatch += 1;
+                }
+                if (legal != transformed[t].getLegalMask()) mismatch += 1;
+            }
+            if (hashes[canonical.transform] != canonical.hash || hashes[0] != game.hash()) mismatch += 1;
+
+            moves.push_back({-1, -1});
+            std::uniform_int_distribution<> distribution(0, moves.size() - 1);
+            auto move = moves[distribution(gen)];
+            game.move(move.first, move.second);
+            for (int t = 0; t < SYMMETRY_NUM; t++)
+            {
+                auto [i, j] = transformPoint(move, t);
+                transformed[t].move(i, j);
+            }
+        }
+    }
+    return mismatch;
+}
+
+/**
+ * @brief An evaluation which is the same in every transform of the board, as a symmetric network would give:
+ *        the prior of a legal point only depends on its stone neighbours, the value on the stone counts.
+ * @param game: the position.
+ * @param value: set to the value of the position.
+ * @return OutputArray: the policy of the position.
+ */
+OutputArray equivariantEvaluation(const GoGame& game, float& value)
+{
+    OutputArray policy{};
+    int stones[3] = {0, 0, 0};
+    for (int i = 0; i < BOARD_SIZE; i++)
+    {
+        for (int j = 0; j < BOARD_SIZE; j++)
+        {
+            stones[static_cast<int>(game.getStone(i, j))] += 1;
+            if (!(game.getLegalMask() & pointMask(i, j))) continue;
+            float prior = 1;
+            for (auto [di, dj] : {std::make_pair(-1, 0), std::make_pair(1, 0), std::make_pair(0, -1), std::make_pair(0, 1)})
+            {
+                int ni = i + di, nj = j + dj;
+                if (ni < 0 || ni >= BOARD_SIZE || nj < 0 || nj >= BOARD_SIZE) continue;
+                prior += (game.getStone(ni, nj) == Stone::Black) ? 2 : (game.getStone(ni, nj) == Stone::White) ? 3 : 0.5f;
+            }
+            policy[i * BOARD_SIZE + j] = prior;
+        }
+    }
+    policy[BOARD_SIZE * BOARD_SIZE] = 1;
+    value = static_cast<float>(stones[static_cast<int>(Stone::Black)] + 1) / (stones[static_cast<int>(Stone::White)] + 2);
+    return policy;
+}
+
+/**
+ * @brief Check the canonical evaluation cache along seeded random games:
+ *        every game is also played in its 8 transforms, each position is looked up and put if it is missing,
+ *        a hit must give the same policy and value as the evaluation of the position itself.
+ * @param nGames: the number of games to play.
+ * @param hitRate: set to the hit rate of the cache.
+ * @return int: the number of mismatches.
+ */
+int verifyCanonicalCache(int nGames, double& hitRate)
+{
+    int mismatch = 0;
+    std::mt19937 gen(BENCH_SEED);
+    EvaluationCache cache(1 << 16, true);
+
+    for (int n = 0; n < nGames; n++)
+    {
+        GoGame game = GoGame();
+        std::array<GoGame, SYMMETRY_NUM> transformed{};
+        while (!game.isGameOver())
+        {
+            for (int t = 0; t < SYMMETRY_NUM; t++)
+            {
+                float value, cachedValue;
+                auto policy = equivariantEvaluation(transformed[t], value);
+                OutputArray cachedPolicy;
+                if (!cache.tryGet(transformed[t], cachedPolicy, cachedValue))
+                    cache.put(transformed[t], policy, value);
+                else if (cachedPolicy != policy || cachedValue != value)
+                    mismatch += 1;
+            }
+
+            auto moves = game.getPossiblePlacements();
+            moves.push_back({-1, -1});
+            std::uniform_int_distribution<> distribution(0, moves.size() - 1);
+            auto move = moves[distribution(gen)];
+            game.move(move.first, move.second);
+            for (int t = 0; t < SYMMETRY_NUM; t++)
+            {
+                auto [i, j] = transformPoint(move, t);
+                transformed[t].move(i, j);
+            }
+        }
+    }
+    hitRate = cache.hitRate();
+    return mismatch;
+}
+
+void showResult(const std::string& name, const BenchResult& result, const BenchResult& baseline, const std::string& unit = "moves/s")
+{
+    std::cout << std::left << std::setw(18) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(0) << result.nMove / result.seconds << " " << unit
+              << "  x" << std::setprecision(2) << baseline.seconds / result.seconds << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    int nGames = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_BENCH_GAMES;
+
+    auto goGame   = playRandomGames<GoGame>(nGames);
+    auto bitboard = playRandomGames<BitboardGoGame>(nGames);
+
+    std::cout << "Random games: " << nGames << std::endl;
+    showResult("GoGame", goGame, goGame);
+    showResult("BitboardGoGame", bitboard, goGame);
+
+    auto goGameExpand   = expandMidgame<GoGame>(nGames);
+    auto bitboardExpand = expandMidgame<BitboardGoGame>(nGames);
+
+    std::cout << "Midgame expansions: " << nGames << std::endl;
+    showResult("GoGame", goGameExpand, goGameExpand, "children/s");
+    showResult("BitboardGoGame", bitboardExpand, goGameExpand, "children/s");
+    auto inPlaceExpand = expandMidgameInPlace(nGames);
+    showResult("GoGame make/undo", inPlaceExpand, goGameExpand, "children/s");
+
+    int undoMismatch = verifyUndo(nGames / 10);
+    std::cout << "make/undo and legal mask mismatches: " << undoMismatch << std::endl;
+
+    int symmetryMismatch = verifySymmetry(nGames / 10);
+    std::cout << "symmetry mismatches: " << symmetryMismatch << std::endl;
+
+    double cacheHitRate = 0;
+    int cacheMismatch = verifyCanonicalCache(nGames / 100, cacheHitRate);
+    std::cout << "canonical cache mismatches: " << cacheMismatch
+              << " (hit rate " << std::setprecision(3) << cacheHitRate << ")" << std::endl;
+
+    // both classes follow the same rules, so the same seed must give the same games
+    if (goGame.checksum != bitboard.checksum || goGame.nMove != bitboard.nMove ||
+        goGameExpand.checksum != bitboardExpand.checksum || goGameExpand.checksum != inPlaceExpand.checksum)
+    {
+        std::cout << "Mismatch between GoGame and BitboardGoGame" << std::endl;
+        return 1;
+    }
+    if (undoMismatch != 0 || symmetryMismatch != 0 || cacheMismatch != 0) return 1;
+    return 0;
+}
@@ -3,26 +3,65 @@
 #include <array>
 #include <cstddef> // size_t
 
-constexpr int   BOARD_SIZE = 5;
+constexpr int   BOARD_SIZE = 5;                 // the default board size, GoGame, MCTSAI, ... are the classes of this size
 constexpr float KOMI       = 2.5;
 constexpr int   NUMBER_OF_INPUT_CHANNELS = 5;
 
-typedef std::array<std::array<std::array<float,BOARD_SIZE>,BOARD_SIZE>,NUMBER_OF_INPUT_CHANNELS> InputArray;
-typedef std::array<float,BOARD_SIZE * BOARD_SIZE + 1> OutputArray;
+// The board sizes which the templates are instantiated for, see the end of GoGame.cpp, MCTSAI.cpp, ...
+constexpr int SUPPORTED_BOARD_SIZES[] = {5, 7, 9};
+
+template<int N>
+using BasicInputArray = std::array<std::array<std::array<float,N>,N>,NUMBER_OF_INPUT_CHANNELS>;
+template<int N>
+using BasicOutputArray = std::array<float,N * N + 1>;
+
+typedef BasicInputArray<BOARD_SIZE>  InputArray;
+typedef BasicOutputArray<BOARD_SIZE> OutputArray;
 
 constexpr const char* const INPUT_NAMES[1]  = {"gameBoard"};
-constexpr const char* const OUTPUT_NAMES[1] = {"policy"};
+constexpr const char* const OUTPUT_NAMES[2] = {"policy", "value"};   // value is optional, the win rate of the player to move
 
 constexpr float C_PUCT = 1.1;
 
 constexpr bool USE_NEURAL_NETWORK = true;
 
+constexpr bool USE_VALUE_HEAD = true;   // back up the value of the model at a new leaf instead of a rollout, if the model has a value output
+
+constexpr bool USE_TRANSPOSITION_TABLE = false;   // share the node of a position reached by different move orders, the tree becomes a DAG
+
+// Progressive widening: the children are ordered by their priors, a node with n visits only selects
+// among its first 1 + WIDENING_C * n ^ WIDENING_ALPHA children.
+constexpr bool  USE_PROGRESSIVE_WIDENING = false;
+constexpr float WIDENING_C               = 2.0;
+constexpr float WIDENING_ALPHA           = 0.5;
+
 constexpr unsigned int DEFAULT_ITERATION = 400;
 
 constexpr unsigned int DEFAULT_NUM_OF_INFERENCE_THREAD = 2;   // 0 for using all available threads
 
-constexpr size_t MAX_CACHE_SIZE = 10000;
+constexpr unsigned int DEFAULT_NUM_OF_SEARCH_THREAD = 1;      // the threads which descend the MCTS tree together, 0 for all cores
+
+constexpr unsigned int NODE_ARENA_CHUNK_SIZE = 1 << 12;   // the number of MCTS nodes or children blocks allocated at once
+
+constexpr size_t MAX_TREE_MEMORY   = size_t(1) << 30;   // the bytes of the nodes and children of a search tree, a full tree stops growing and refines its leaves
+constexpr double TREE_RECYCLE_FILL = 0.5;               // a reused tree fuller than this is copied to a fresh arena if the subtree of the new root fills less, the rest is freed
+
+constexpr int VIRTUAL_LOSS = 1;                               // the losses added to a node for every search thread below it
+
+constexpr size_t DEFAULT_MAX_BATCH_SIZE   = 16;    // the most positions the search threads evaluate in one inference
+constexpr int    DEFAULT_BATCH_TIMEOUT_US = 200;   // the longest time a position waits for its batch to be filled
+
+constexpr size_t MAX_CACHE_SIZE = 10000;   // the positions in the evaluation cache, 0 for no cache
+constexpr bool   CANONICAL_CACHE = false;  // the symmetric positions share one entry of the evaluation cache, the network must be symmetric
 
 constexpr float FORCE_SELECT_K = 0.5;
 
+constexpr bool USE_MCTS_SOLVER = true;   // prove the wins and losses of the end of the game up the tree, a solved subtree is not searched
+
+constexpr bool USE_EARLY_STOP        = true;   // a timed search stops once its most visited move can not change any more
+constexpr int  EARLY_STOP_MIN_VISITS = 100;    // the visits of a timed search before its speed is trusted for the early stop
+
+constexpr int  KO_HISTORY_SIZE = 8;       // the number of previous positions kept for KO detection
+constexpr bool USE_SUPERKO     = false;   // false for simple KO, true for positional superko over KO_HISTORY_SIZE positions
+
 constexpr const char* const HDF5_PATH = "/home/xuyisen/project/Go_game/KataGoLike/data/";
\ No newline at end of file
@@ -12,10 +12,11 @@
 /**
  * @brief return the number of stones on the board.
  * @param board: the current board, a 1D array of size board_size * board_size. 0 for empty, 1 for black, 2 for white.
+ * @param boardSize: the size of the board.
  * 
  * @return int: the number of stones on the board.
  */
-int getNStones(int* board);
+int getNStones(int* board, int boardSize);
 /**
  * @brief judge one process exists or not
  * @param pid_t: the pid of the process
@@ -35,10 +36,11 @@ void removeUselessFile(const char* dirStr);
  * @param logPathObj: the path of the log file
  * @param board: the current board, a 1D array of size board_size * board_size. 0 for empty, 1 for black, 2 for white.
  * @param nowPiece: the piece that should be placed. 1 for black, 2 for white.
+ * @param boardSize: the size of the board.
  * 
  * @return int: the number of moves
 */
-int getNMove(std::filesystem::path logPathObj, int* board, int nowPiece);
+int getNMove(std::filesystem::path logPathObj, int* board, int nowPiece, int boardSize);
 
 /**
  * @brief return the directory of the path
@@ -52,8 +54,15 @@ std::filesystem::path returnDirectory(std::filesystem::path path);
  * @brief write the number of moves to the log file
  * @param logPathObj: the path of the log file
  * @param nMove: the number of moves
+ * @param boardSize: the size of the board.
 */
-void writeNMove(std::filesystem::path logPathObj, int nMove);
+void writeNMove(std::filesystem::path logPathObj, int nMove, int boardSize);
+
+/**
+ * @brief get_input of a board size known at compile time, see get_input.
+ */
+template<int N>
+int getInput(int* board, int* previousBoard, int nowPiece, const char * onnxPath, int timeLimit, const char* logPath);
 
 /**
  * @brief This function will be called by the get_input function in the MyPlayer class in Python.
@@ -68,6 +77,28 @@ void writeNMove(std::filesystem::path logPathObj, int nMove);
  * @return int: the index of cross point in the board to place the stone. i * board_size + j, where i is the row index and j is the column index. -1 for pass.
 */
 extern "C" int get_input(int* board, int* previousBoard, int nowPiece, const char * onnxPath, int timeLimit, const char* logPath) {
+    return getInput<BOARD_SIZE>(board, previousBoard, nowPiece, onnxPath, timeLimit, logPath);
+}
+
+/**
+ * @brief The same as get_input, for a board of any supported size.
+ * 
+ * @param boardSize: the size of the board, 5, 7 or 9.
+ * 
+ * @return int: the index of cross point in the board to place the stone, -1 for pass or an unsupported size.
+*/
+extern "C" int get_input_sized(int boardSize, int* board, int* previousBoard, int nowPiece, const char * onnxPath, int timeLimit, const char* logPath) {
+    switch (boardSize)
+    {
+        case 5: return getInput<5>(board, previousBoard, nowPiece, onnxPath, timeLimit, logPath);
+        case 7: return getInput<7>(board, previousBoard, nowPiece, onnxPath, timeLimit, logPath);
+        case 9: return getInput<9>(board, previousBoard, nowPiece, onnxPath, timeLimit, logPath);
+        default: return -1;
+    }
+}
+
+template<int N>
+int getInput(int* board, int* previousBoard, int nowPiece, const char * onnxPath, int timeLimit, const char* logPath) {
     
     using namespace std::filesystem;
 
@@ -76,13 +107,13 @@ extern "C" int get_input(int* board, int* previousBoard, int nowPiece, const cha
     std::string fileName = std::to_string(getppid()) + ".txt";
     path logPathObj = returnDirectory(path(logPath)) / fileName;
 
-    int nMove = getNMove(logPathObj, board, nowPiece);
+    int nMove = getNMove(logPathObj, board, nowPiece, N);
 
     // Create a GoGame object.
-    GoGame game(board, previousBoard, nowPiece, nMove);
+    BasicGoGame<N> game(board, previousBoard, nowPiece, nMove);
 
     // write the nMove to the log file
-    writeNMove(logPathObj, game.getNMove());
+    writeNMove(logPathObj, game.getNMove(), N);
 
     // Show the board and liberties, for debugging.
     // game.showBoard();
@@ -93,16 +124,16 @@ extern "C" int get_input(int* board, int* previousBoard, int nowPiece, const cha
     removeThread.detach();
 
     // Create a AI object
-    TimeLimitMCTSAI ai = TimeLimitMCTSAI(onnxPath, 2, timeLimit);
-    int move = boardPairToInt(ai.move(game));
+    BasicTimeLimitMCTSAI<N> ai = BasicTimeLimitMCTSAI<N>(onnxPath, 2, std::chrono::seconds(timeLimit));
+    int move = boardPairToInt<N>(ai.move(game));
     
     return move;
 }
 
-int getNStones(int* board)
+int getNStones(int* board, int boardSize)
 {
     int n = 0;
-    for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+    for (int i = 0; i < boardSize * boardSize; i++)
         if (board[i] != 0) n++;
     return n;
 }
@@ -144,12 +175,12 @@ void removeUselessFile(const char* dirStr)
     }
 }
 
-int getNMove(std::filesystem::path logPathObj, int* board, int nowPiece)
+int getNMove(std::filesystem::path logPathObj, int* board, int nowPiece, int boardSize)
 {
     int nMove = -1; // the number of moves
 
     // if the num of stones less than 2, the nMove depends on nowPiece
-    if (getNStones(board) <= 1)
+    if (getNStones(board, boardSize) <= 1)
     {
         if (nowPiece == 1) nMove = 0;
         else nMove = 1;
@@ -180,9 +211,9 @@ std::filesystem::path returnDirectory(std::filesystem::path path)
     }
 }
 
-void writeNMove(std::filesystem::path logPathObj, int nMove)
+void writeNMove(std::filesystem::path logPathObj, int nMove, int boardSize)
 {
-    if (nMove != -1 && nMove < 22) {
+    if (nMove != -1 && nMove < boardSize * boardSize - 3) {
         std::ofstream logFile(logPathObj);
         if (logFile.is_open())
         {
@@ -37,7 +37,7 @@ int main(int argc, char *argv[])
         std::cin >> i;
         if (i > 0)
         {
-            ai = std::make_unique<TimeLimitMCTSAI>("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, i);
+            ai = std::make_unique<TimeLimitMCTSAI>("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, std::chrono::seconds(i));
             break;
         }
     }
@@ -0,0 +1,115 @@
+#include<iostream>
+#include<iomanip>
+#include<chrono>
+#include<string>
+#include<vector>
+
+#include "GoGame/GoGame.h"
+
+/**
+ * @brief A perft position: the moves from the empty board, and the reference node counts of each depth.
+ */
+struct PerftCase
+{
+    std::string                     name;
+    std::vector<Point>              moves;
+    std::vector<unsigned long long> counts;
+};
+
+// The reference counts are computed by the original rules engine, every optimization of GoGame must keep them.
+// Pass is always a move, a game which is over is a leaf.
+const std::vector<PerftCase> PERFT_CASES =
+{
+    {
+        "empty board",
+        {},
+        {1ULL, 26ULL, 651ULL, 15651ULL, 361067ULL, 7984755ULL}
+    },
+    {
+        "midgame",
+        {{2, 2}, {2, 3}, {1, 2}, {3, 3}, {3, 2}, {1, 3}, {2, 1}, {0, 3}, {1, 1}, {3, 1}},
+        {1ULL, 16ULL, 241ULL, 3375ULL, 44168ULL, 531397ULL}
+    },
+    {
+        "ko",
+        {{0, 1}, {0, 2}, {1, 0}, {2, 2}, {2, 1}, {1, 3}, {4, 4}, {1, 1}},
+        {1ULL, 18ULL, 305ULL, 4871ULL, 73250ULL, 1031955ULL}
+    },
+};
+
+/**
+ * @brief Count the leaves of the tree of all legal move sequences.
+ * @param game: the position.
+ * @param depth: the number of plies to enumerate.
+ * @return unsigned long long: the number of leaves.
+ */
+unsigned long long perft(const GoGame& game, int depth)
+{
+    if (depth == 0 || game.isGameOver()) return 1;
+
+    unsigned long long count = 0;
+    auto moves = game.getPossiblePlacements();
+    for (auto [i, j] : moves)
+    {
+        GoGame child = game;
+        child.move(i, j);
+        count += perft(child, depth - 1);
+    }
+    // you can always pass
+    GoGame child = game;
+    child.move(-1, -1);
+    count += perft(child, depth - 1);
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    using namespace std::chrono;
+
+    // only check the depths up to the given one, to run faster
+    int maxDepth = (argc > 1) ? std::stoi(argv[1]) : -1;
+    int mismatch = 0;
+    unsigned long long totalNodes = 0;
+    double totalSeconds = 0;
+
+    for (const auto& perftCase : PERFT_CASES)
+    {
+        GoGame game = GoGame();
+        for (auto [i, j] : perftCase.moves)
+        {
+            if (!game.move(i, j))
+            {
+                std::cout << perftCase.name << ": illegal move (" << i << ", " << j << ")" << std::endl;
+                return 1;
+            }
+        }
+
+        std::cout << perftCase.name << std::endl;
+        for (int depth = 1; depth < static_cast<int>(perftCase.counts.size()); depth++)
+        {
+            if (maxDepth >= 0 && depth > maxDepth) break;
+
+            auto start = steady_clock::now();
+            auto count = perft(game, depth);
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            totalNodes   += count;
+            totalSeconds += seconds;
+
+            bool ok = (count == perftCase.counts[depth]);
+            if (!ok) mismatch += 1;
+            std::cout << "  depth " << depth
+                      << std::right << std::setw(12) << count << " nodes"
+                      << std::setw(14) << std::fixed << std::setprecision(0) << count / std::max(seconds, 1e-9) << " nodes/s"
+                      << (ok ? "" : "  expected " + std::to_string(perftCase.counts[depth])) << std::endl;
+        }
+    }
+
+    std::cout << "total " << totalNodes << " nodes, "
+              << std::fixed << std::setprecision(0) << totalNodes / std::max(totalSeconds, 1e-9) << " nodes/s" << std::endl;
+    if (mismatch != 0)
+    {
+        std::cout << mismatch << " counts are different from the reference" << std::endl;
+        return 1;
+    }
+    return 0;
+}
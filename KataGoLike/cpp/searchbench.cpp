@@ -0,0 +1,206 @@
+#include<iostream>
+#include<iomanip>
+#include<chrono>
+#include<string>
+#include<vector>
+#include<algorithm>
+#include<random>
+
+#include "GoGame/GoGame.h"
+#include "AI/MCTSAI.h"
+#include "AI/ExhaustiveTree.h"
+
+constexpr int DEFAULT_SEARCH_STEPS = 20000;
+constexpr unsigned int VERIFY_SEED = 20240403;
+constexpr int VERIFY_POSITIONS    = 40;
+constexpr int VERIFY_OPENING_MOVES = 16;     // the random moves before a checked position, late enough to be solved
+constexpr int VERIFY_MAX_SELECTS  = 3000;
+constexpr int SOLVER_MAX_SELECTS  = 200000;
+const std::vector<unsigned int> SEARCH_THREAD_NUMS = {1, 2, 4, 8, 16, 32};
+
+/**
+ * @brief An inference engine which gives every move the same probability, so the search is measured without a model.
+ *        With a value output, every position is even.
+ */
+class UniformInferenceEngine : public NeuralNetworkInferenceEngine
+{
+public:
+    explicit UniformInferenceEngine(bool withValue) : _withValue(withValue) {}
+
+    void inference([[maybe_unused]] float *input, float *output, std::size_t batchSize) override
+    {
+        std::fill_n(output, batchSize * (BOARD_SIZE * BOARD_SIZE + 1), 1.0f / (BOARD_SIZE * BOARD_SIZE + 1));
+    }
+
+    void inference([[maybe_unused]] float *input, float *output, float *value, std::size_t batchSize) override
+    {
+        inference(input, output, batchSize);
+        if (_withValue) std::fill_n(value, batchSize, 0.5f);
+    }
+
+    bool hasValue() const override
+    {
+        return _withValue;
+    }
+
+private:
+    bool _withValue;
+};
+
+/**
+ * @brief Play seeded random moves from the empty board, passes included.
+ * @param gen: the random generator.
+ * @param nMove: the number of moves, fewer if the game ends.
+ * @return GoGame: the game.
+ */
+GoGame randomPosition(std::mt19937& gen, int nMove)
+{
+    GoGame game = GoGame();
+    while (!game.isGameOver() && game.getNMove() < nMove)
+    {
+        auto moves = game.getPossiblePlacements();
+        moves.push_back({-1, -1});
+        std::uniform_int_distribution<> distribution(0, moves.size() - 1);
+        auto [i, j] = moves[distribution(gen)];
+        game.move(i, j);
+    }
+    return game;
+}
+
+/**
+ * @brief Check the early stop of a timed search against the move it plays:
+ *        on seeded random late positions the root is searched one select at a time, and whenever
+ *        isDecided holds for an unsolved root, bestChild must lead every other move which is not proven to lose
+ *        by more than the remaining visits. A refuted move with many visits must not decide the search.
+ * @return int: the number of mismatches.
+ */
+int verifyEarlyStop()
+{
+    int mismatch = 0;
+    std::mt19937 gen(VERIFY_SEED);
+    InferenceEngine engine(std::make_unique<UniformInferenceEngine>(true));
+
+    for (int n = 0; n < VERIFY_POSITIONS; n++)
+    {
+        GoGame game = randomPosition(gen, VERIFY_OPENING_MOVES);
+        if (game.isGameOver()) continue;
+
+        BasicTreeArena<BOARD_SIZE> arena;
+        MCTNode root(game, &engine, &arena, false);
+        for (int step = 0; step < VERIFY_MAX_SELECTS && !root.isProven(); step++)
+        {
+            root.search(1, 1);
+            if (root.getChildNum() <= 1) continue;
+            for (int remainingVisits : {0, 10, 100})
+            {
+                if (!root.isDecided(remainingVisits) || root.isProven()) continue;
+                int best = root.bestChild();
+                if (best == -1 || root.isLostChild(best))
+                {
+                    mismatch += 1;
+                    continue;
+                }
+                for (int k = 0; k < root.getChildNum(); k++)
+                {
+                    if (k == best || root.isLostChild(k)) continue;
+                    if (root.getChildVisitTimes(best) - root.getChildVisitTimes(k) <= remainingVisits) mismatch += 1;
+                }
+            }
+        }
+    }
+    return mismatch;
+}
+
+/**
+ * @brief Check the MCTS-solver against the ExhaustiveTree: on seeded random late positions which the exhaustive
+ *        search solves, the root is searched until it is proven, it must be won exactly when there is a winning move.
+ * @param checked: set to the number of positions which both searches solve.
+ * @return int: the number of mismatches.
+ */
+int verifySolver(int& checked)
+{
+    int mismatch = 0;
+    checked = 0;
+    std::mt19937 gen(VERIFY_SEED);
+    InferenceEngine engine(std::make_unique<UniformInferenceEngine>(true));
+
+    for (int n = 0; n < VERIFY_POSITIONS; n++)
+    {
+        GoGame game = randomPosition(gen, VERIFY_OPENING_MOVES);
+        if (game.isGameOver()) continue;
+
+        ExhaustiveTree tree(game);
+        auto mustWinMove = tree.getMustWinMove();
+        auto outcome = tree.getOutcome();
+        if (outcome != ExhaustiveTree::Outcome::WIN && outcome != ExhaustiveTree::Outcome::NO_WIN) continue;
+
+        BasicTreeArena<BOARD_SIZE> arena;
+        MCTNode root(game, &engine, &arena, false);
+        root.search(SOLVER_MAX_SELECTS, 1, [&root]() { return root.isProven(); });
+        if (!root.isProven()) continue;
+        checked += 1;
+        if (root.isWon() != mustWinMove.has_value()) mismatch += 1;
+    }
+    return mismatch;
+}
+
+/**
+ * @brief Measure the visits per second of the tree-parallel search with 1 to 32 threads.
+ *        usage: searchbench [steps] [onnx model path], the uniform engine is used without a model,
+ *        once with rollouts and once with a value output.
+ */
+int main(int argc, char *argv[])
+{
+    using namespace std::chrono;
+
+    int steps = (argc > 1) ? std::stoi(argv[1]) : DEFAULT_SEARCH_STEPS;
+    const char* onnxPath = (argc > 2) ? argv[2] : nullptr;
+
+    int earlyStopMismatch = verifyEarlyStop();
+    std::cout << "early stop mismatches: " << earlyStopMismatch << std::endl;
+    int solverChecked = 0;
+    int solverMismatch = verifySolver(solverChecked);
+    std::cout << "solver mismatches: " << solverMismatch << " of " << solverChecked << " solved positions" << std::endl;
+
+    // the opening of bench.cpp, a midgame with enough moves to search
+    GoGame game = GoGame();
+    for (auto [i, j] : {Point{2, 2}, Point{2, 3}, Point{1, 2}, Point{3, 3}, Point{3, 2}, Point{1, 3}})
+    {
+        game.move(i, j);
+    }
+
+    // a model decides itself whether it has a value output
+    std::vector<bool> valueModes = onnxPath ? std::vector<bool>{false} : std::vector<bool>{false, true};
+    for (bool withValue : valueModes)
+    {
+        double baseline = 0;
+        std::cout << "Search steps: " << steps
+                  << (onnxPath ? std::string(", model: ") + onnxPath : withValue ? ", uniform policy, value" : ", uniform policy, rollouts")
+                  << std::endl;
+        for (auto searchThreadNum : SEARCH_THREAD_NUMS)
+        {
+            std::unique_ptr<NeuralNetworkInferenceEngine> engine;
+            if (onnxPath)
+                engine = makeSearchEngine<BOARD_SIZE>(onnxPath, 1, searchThreadNum);
+            else
+                engine = std::make_unique<UniformInferenceEngine>(withValue);
+            MCTSAI ai(std::move(engine), steps, false, searchThreadNum);
+
+            auto start = steady_clock::now();
+            auto [i, j] = ai.move(game);
+            double seconds = duration<double>(steady_clock::now() - start).count();
+            double visits  = steps / seconds;
+            if (searchThreadNum == 1) baseline = visits;
+
+            std::cout << std::left << std::setw(4) << searchThreadNum << " threads"
+                      << std::right << std::setw(12) << std::fixed << std::setprecision(0) << visits << " visits/s"
+                      << "  x" << std::setprecision(2) << visits / baseline
+                      << "  move (" << i << ", " << j << ")";
+            if (auto cache = ai.getInferenceEngine().getCache())
+                std::cout << "  cache hit rate " << std::setprecision(3) << cache->hitRate();
+            std::cout << std::endl;
+        }
+    }
+    if (earlyStopMismatch != 0 || solverMismatch != 0) return 1;
+    return 0;
+}
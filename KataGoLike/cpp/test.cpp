@@ -8,8 +8,8 @@
 
 int main(int argc, char *argv[])
 {
-    std::unique_ptr<AI> ai1 = std::make_unique<TimeLimitMCTSAI>("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, 10);
-    std::unique_ptr<AI> ai2 = std::make_unique<TimeLimitMCTSAI>("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, 10);
+    std::unique_ptr<AI> ai1 = std::make_unique<TimeLimitMCTSAI>("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, std::chrono::seconds(10));
+    std::unique_ptr<AI> ai2 = std::make_unique<TimeLimitMCTSAI>("/home/xuyisen/project/Go_game/KataGoLike/python/model9.onnx", 2, std::chrono::seconds(10));
 
     int ai1BlackWin = 0; int ai2BlackWin = 0;
     int ai1WhiteWin = 0; int ai2WhiteWin = 0;
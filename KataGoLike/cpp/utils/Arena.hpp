@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstdint> // SIZE_MAX
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief A slab allocator of objects, they are only freed all together.
+ *
+ * The memory is taken from chunks of chunkSize objects, a block of several objects is always contiguous.
+ * clear() frees all objects at once without calling destructors, so T must be trivially destructible,
+ * and keeps the chunks to be used again. With a capacity it never holds more objects than that,
+ * allocate returns nullptr when it is full. It is thread safe.
+ */
+template<class T>
+class Arena
+{
+    static_assert(std::is_trivially_destructible_v<T>, "the objects of an Arena are freed without destructors");
+
+    private:
+        struct Chunk
+        {
+            T*          data;
+            std::size_t capacity;
+        };
+
+        std::allocator<T>  _allocator{};
+        std::vector<Chunk> _chunks{};
+        std::size_t        _chunkSize;
+        // the chunk which is being used, and the number of objects taken from it
+        std::size_t        _current = 0;
+        std::size_t        _used    = 0;
+        // the objects taken since the last clear
+        std::size_t        _size    = 0;
+        // the most objects taken since the last clear
+        std::size_t        _capacity;
+        std::mutex         _mutex{};
+
+    public:
+        explicit Arena(std::size_t chunkSize, std::size_t capacity = SIZE_MAX)
+            : _chunkSize(std::max<std::size_t>(chunkSize, 1)), _capacity(capacity) {}
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena()
+        {
+            for (auto& chunk : _chunks)
+            {
+                _allocator.deallocate(chunk.data, chunk.capacity);
+            }
+        }
+
+        /**
+         * @brief Get the memory of n contiguous objects, they are not constructed.
+         * @param n: the number of objects.
+         * @return T*: the first object, nullptr if the arena would hold more objects than its capacity.
+         */
+        T* allocate(std::size_t n)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (n > _capacity - _size) return nullptr;
+            while (_current < _chunks.size() && _used + n > _chunks[_current].capacity)
+            {
+                _current++;
+                _used = 0;
+            }
+            if (_current == _chunks.size())
+            {
+                // the last chunk is not larger than the rest of the capacity
+                auto capacity = std::max(std::min(_chunkSize, _capacity - _size), n);
+                _chunks.push_back({_allocator.allocate(capacity), capacity});
+                _used = 0;
+            }
+            T* block = _chunks[_current].data + _used;
+            _used += n;
+            _size += n;
+            return block;
+        }
+
+        /**
+         * @brief Free all objects, the chunks are kept for the next objects.
+         */
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _current = 0;
+            _used    = 0;
+            _size    = 0;
+        }
+
+        /**
+         * @brief Get the number of objects taken since the last clear.
+         * @return std::size_t: the number of objects.
+         */
+        std::size_t size()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _size;
+        }
+
+        /**
+         * @brief Get the most objects the arena holds.
+         * @return std::size_t: the capacity, SIZE_MAX if it is not bounded.
+         */
+        std::size_t capacity() const { return _capacity; }
+
+        /**
+         * @brief Get the memory of all chunks, the used and the free ones.
+         * @return std::size_t: the bytes.
+         */
+        std::size_t memoryBytes()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::size_t capacity = 0;
+            for (auto& chunk : _chunks)
+            {
+                capacity += chunk.capacity;
+            }
+            return capacity * sizeof(T);
+        }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "../constant.h"
+
+// One bit per point of a N * N board, bit i * N + j is the point (i, j).
+// 5x5 fits in 32 bits, 7x7 in 64 bits, 9x9 needs 128 bits.
+template<int N>
+using BasicBoardMask = std::conditional_t<(N * N <= 32), uint32_t,
+                       std::conditional_t<(N * N <= 64), uint64_t, unsigned __int128>>;
+
+typedef BasicBoardMask<BOARD_SIZE> BoardMask;
+
+template<int N>
+constexpr BasicBoardMask<N> makeFullMask()
+{
+    BasicBoardMask<N> mask = 0;
+    for (int i = 0; i < N * N; i++) mask |= BasicBoardMask<N>(1) << i;
+    return mask;
+}
+
+template<int N>
+constexpr BasicBoardMask<N> makeColumnMask(int j)
+{
+    BasicBoardMask<N> mask = 0;
+    for (int i = 0; i < N; i++) mask |= BasicBoardMask<N>(1) << (i * N + j);
+    return mask;
+}
+
+template<int N = BOARD_SIZE>
+inline constexpr BasicBoardMask<N> FULL_MASK         = makeFullMask<N>();
+template<int N = BOARD_SIZE>
+inline constexpr BasicBoardMask<N> FIRST_COLUMN_MASK = makeColumnMask<N>(0);
+template<int N = BOARD_SIZE>
+inline constexpr BasicBoardMask<N> LAST_COLUMN_MASK  = makeColumnMask<N>(N - 1);
+
+/**
+ * @brief Get the mask of a single point.
+ * @param i: the row index of the point.
+ * @param j: the column index of the point.
+ * @return BasicBoardMask<N>: the mask with only the point set.
+ */
+template<int N = BOARD_SIZE>
+constexpr BasicBoardMask<N> pointMask(int i, int j)
+{
+    return BasicBoardMask<N>(1) << (i * N + j);
+}
+
+/**
+ * @brief Get the points which are orthogonally adjacent to the mask, the mask itself is excluded.
+ * @param mask: the mask.
+ * @return BasicBoardMask<N>: the adjacent points.
+ */
+template<int N = BOARD_SIZE>
+constexpr BasicBoardMask<N> adjacentMask(BasicBoardMask<N> mask)
+{
+    BasicBoardMask<N> grown = (mask << N)                                 // down
+                            | (mask >> N)                                 // up
+                            | ((mask & ~LAST_COLUMN_MASK<N>) << 1)        // right
+                            | ((mask & ~FIRST_COLUMN_MASK<N>) >> 1);      // left
+    return grown & FULL_MASK<N> & ~mask;
+}
+
+/**
+ * @brief Get all points of region which are connected to seed through region.
+ * @param seed: the start points, should be a subset of region.
+ * @param region: the points which can be walked through.
+ * @return BasicBoardMask<N>: the connected points.
+ */
+template<int N = BOARD_SIZE>
+constexpr BasicBoardMask<N> floodFill(BasicBoardMask<N> seed, BasicBoardMask<N> region)
+{
+    BasicBoardMask<N> filled = seed & region;
+    while (true)
+    {
+        BasicBoardMask<N> next = (filled | adjacentMask<N>(filled)) & region;
+        if (next == filled) return filled;
+        filled = next;
+    }
+}
+
+/**
+ * @brief Count the points in a mask.
+ * @param mask: the mask.
+ * @return int: the number of points.
+ */
+inline int popCount(uint32_t mask)
+{
+    return __builtin_popcount(mask);
+}
+
+inline int popCount(uint64_t mask)
+{
+    return __builtin_popcountll(mask);
+}
+
+inline int popCount(unsigned __int128 mask)
+{
+    return __builtin_popcountll(static_cast<uint64_t>(mask)) + __builtin_popcountll(static_cast<uint64_t>(mask >> 64));
+}
+
+/**
+ * @brief Get the index of the lowest point in a non-empty mask.
+ * @param mask: the mask, must not be 0.
+ * @return int: the index of the point, i * N + j.
+ */
+inline int lowestPoint(uint32_t mask)
+{
+    return __builtin_ctz(mask);
+}
+
+inline int lowestPoint(uint64_t mask)
+{
+    return __builtin_ctzll(mask);
+}
+
+inline int lowestPoint(unsigned __int128 mask)
+{
+    auto low = static_cast<uint64_t>(mask);
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(mask >> 64));
+}
@@ -5,11 +5,11 @@
 
 #include"../constant.h"
 
-template<class T>
+template<class T, int N = BOARD_SIZE>
 class BoardMap
 {
     private:
-        std::array<std::array<std::optional<T>, BOARD_SIZE>,BOARD_SIZE> board;
+        std::array<std::array<std::optional<T>, N>,N> board;
     public:
         BoardMap()
         {
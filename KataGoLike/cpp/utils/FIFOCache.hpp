@@ -38,6 +38,16 @@ public:
         return false;
     }
 
+    size_t size() const
+    {
+        return _size;
+    }
+
+    size_t maxSize() const
+    {
+        return _maxSize;
+    }
+
     void put(const TKey& key, const TValue& value)
     {
         auto it = _cache.find(key);
@@ -48,7 +58,8 @@ public:
         }
         if (_size == _maxSize)
         {
-            auto& keyToRemove = _fifo.front();
+            // copy the key, pop destroys the front
+            auto keyToRemove = _fifo.front();
             _fifo.pop();
             _cache.erase(keyToRemove);
             _fifo.push(key);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef> // size_t
+#include <stdexcept>
+
+/**
+ * @brief A vector with a fixed capacity, the elements are stored in the object itself.
+ * 
+ * It never allocates, so it can be used on hot paths such as the neighbors of a point or the legal moves of a position.
+ * It is trivially copyable if T is.
+ */
+template<class T, std::size_t Capacity>
+class FixedVector
+{
+    private:
+        std::array<T, Capacity> _data{};
+        std::size_t             _size = 0;
+    public:
+        constexpr FixedVector() = default;
+        constexpr FixedVector(const std::array<T, Capacity>& data, std::size_t size) : _data(data), _size(size) {}
+
+        void push_back(const T& value)
+        {
+            if (_size == Capacity) throw std::length_error("FixedVector is full");
+            _data[_size++] = value;
+        }
+
+        void pop_back()       { _size--; }
+        void clear()          { _size = 0; }
+
+        constexpr std::size_t size() const         { return _size; }
+        constexpr bool        empty() const        { return _size == 0; }
+        static constexpr std::size_t capacity()    { return Capacity; }
+
+        T&       operator[](std::size_t i)                 { return _data[i]; }
+        constexpr const T& operator[](std::size_t i) const { return _data[i]; }
+        T&       back()                                    { return _data[_size - 1]; }
+        const T& back() const                              { return _data[_size - 1]; }
+
+        T*       begin()                       { return _data.data(); }
+        T*       end()                         { return _data.data() + _size; }
+        constexpr const T* begin() const       { return _data.data(); }
+        constexpr const T* end() const         { return _data.data() + _size; }
+
+        bool operator==(const FixedVector& other) const
+        {
+            if (_size != other._size) return false;
+            for (std::size_t i = 0; i < _size; i++)
+            {
+                if (!(_data[i] == other._data[i])) return false;
+            }
+            return true;
+        }
+
+        bool operator!=(const FixedVector& other) const
+        {
+            return !(*this == other);
+        }
+};
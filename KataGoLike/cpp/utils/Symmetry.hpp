@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "../constant.h"
+#include "Zobrist.hpp"
+
+// The 8 rotations and reflections of a square board, the dihedral group D4.
+// A transform t first flips the rows if t & 1, then flips the columns if t & 2, then transposes if t & 4,
+// transform 0 is the identity.
+constexpr int SYMMETRY_NUM = 8;
+
+/**
+ * @brief Get the transform which undoes another transform.
+ * @param t: the transform.
+ * @return int: the inverse transform.
+ */
+constexpr int inverseTransform(int t)
+{
+    // undoing a transpose swaps the roles of the row and column flips
+    if (t & 4) return 4 | ((t & 1) << 1) | ((t & 2) >> 1);
+    return t;
+}
+
+/**
+ * @brief Transform a point on the board, pass is not changed.
+ * @param p: the point, {-1, -1} for pass.
+ * @param t: the transform.
+ * @return std::pair<int, int>: the transformed point.
+ */
+template<int N = BOARD_SIZE>
+constexpr std::pair<int, int> transformPoint(std::pair<int, int> p, int t)
+{
+    auto [i, j] = p;
+    if (i == -1 && j == -1) return p;
+    if (t & 1) i = N - 1 - i;
+    if (t & 2) j = N - 1 - j;
+    if (t & 4) return {j, i};
+    return {i, j};
+}
+
+template<int N>
+constexpr std::array<std::array<int, N * N>, SYMMETRY_NUM> makeSymmetryTable()
+{
+    std::array<std::array<int, N * N>, SYMMETRY_NUM> table{};
+    for (int t = 0; t < SYMMETRY_NUM; t++)
+    {
+        for (int index = 0; index < N * N; index++)
+        {
+            auto [i, j] = transformPoint<N>({index / N, index % N}, t);
+            table[t][index] = i * N + j;
+        }
+    }
+    return table;
+}
+
+// SYMMETRY_TABLE<N>[t][i * N + j] is the index of (i, j) after the transform t.
+template<int N>
+inline constexpr std::array<std::array<int, N * N>, SYMMETRY_NUM> SYMMETRY_TABLE = makeSymmetryTable<N>();
+
+template<int N>
+constexpr std::array<std::array<std::array<uint64_t, SYMMETRY_NUM>, N * N>, 2> makeSymmetricZobristTable()
+{
+    std::array<std::array<std::array<uint64_t, SYMMETRY_NUM>, N * N>, 2> table{};
+    for (int stone = 0; stone < 2; stone++)
+    {
+        for (int index = 0; index < N * N; index++)
+        {
+            for (int t = 0; t < SYMMETRY_NUM; t++)
+            {
+                table[stone][index][t] = ZOBRIST_TABLE<N>[stone][SYMMETRY_TABLE<N>[t][index]];
+            }
+        }
+    }
+    return table;
+}
+
+// SYMMETRIC_ZOBRIST_TABLE<N>[stone - 1][i * N + j][t] is the Zobrist key of the stone at (i, j) after the transform t,
+// so the hashes of all 8 transforms of a board are computed in one pass over the stones.
+template<int N>
+inline constexpr std::array<std::array<std::array<uint64_t, SYMMETRY_NUM>, N * N>, 2> SYMMETRIC_ZOBRIST_TABLE =
+    makeSymmetricZobristTable<N>();
+
+// The canonical hash of a position, the smallest hash of its 8 transforms, and the transform giving it.
+struct CanonicalHash
+{
+    uint64_t hash      = 0;
+    int      transform = 0;
+};
+
+/**
+ * @brief Transform a policy, the probability of a point goes to the transformed point, pass is not changed.
+ * @param policy: the policy, N * N points and pass.
+ * @param t: the transform.
+ * @return BasicOutputArray<N>: the transformed policy.
+ */
+template<int N = BOARD_SIZE>
+BasicOutputArray<N> transformPolicy(const BasicOutputArray<N>& policy, int t)
+{
+    BasicOutputArray<N> result{};
+    for (int index = 0; index < N * N; index++)
+    {
+        result[SYMMETRY_TABLE<N>[t][index]] = policy[index];
+    }
+    result[N * N] = policy[N * N];
+    return result;
+}
+
+/**
+ * @brief Transform the input features of a board, every channel is transformed as a board.
+ * @param input: the features.
+ * @param t: the transform.
+ * @return BasicInputArray<N>: the transformed features.
+ */
+template<int N = BOARD_SIZE>
+BasicInputArray<N> transformInput(const BasicInputArray<N>& input, int t)
+{
+    BasicInputArray<N> result{};
+    for (int c = 0; c < NUMBER_OF_INPUT_CHANNELS; c++)
+    {
+        for (int i = 0; i < N; i++)
+        {
+            for (int j = 0; j < N; j++)
+            {
+                auto [x, y] = transformPoint<N>({i, j}, t);
+                result[c][x][y] = input[c][i][j];
+            }
+        }
+    }
+    return result;
+}
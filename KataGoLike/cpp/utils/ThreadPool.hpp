@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef> // size_t
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads which run the submitted tasks in order.
+ *
+ * The threads live as long as the pool, so a task does not pay for starting a thread.
+ * A task which waits for other tasks of the same pool needs enough threads for them,
+ * or it waits forever. The destructor runs the tasks which are still queued, then joins the threads.
+ */
+class ThreadPool
+{
+    private:
+        std::vector<std::thread>          _workers{};
+        std::deque<std::function<void()>> _tasks{};
+        std::mutex                        _mutex{};
+        std::condition_variable           _condition{};
+        bool                              _stop = false;
+
+        void work()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _condition.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+                    if (_tasks.empty()) return;
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        explicit ThreadPool(std::size_t threadNum)
+        {
+            for (std::size_t i = 0; i < threadNum; i++)
+            {
+                _workers.emplace_back(&ThreadPool::work, this);
+            }
+        }
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (auto& worker : _workers)
+            {
+                worker.join();
+            }
+        }
+
+        std::size_t size() const { return _workers.size(); }
+
+        /**
+         * @brief Queue a task, it runs on the first free thread.
+         * @param task: a function without arguments.
+         * @return std::future: the result of the task, or its exception.
+         */
+        template<class F>
+        auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            typedef std::invoke_result_t<std::decay_t<F>> Result;
+
+            // std::function needs a copyable function, so the packaged task is shared
+            auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            auto future = packagedTask->get_future();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.emplace_back([packagedTask]() { (*packagedTask)(); });
+            }
+            _condition.notify_one();
+            return future;
+        }
+};
+
+/**
+ * @brief A flag which asks a task to stop, the copies of a token share the flag.
+ */
+class CancellationToken
+{
+    private:
+        std::shared_ptr<std::atomic<bool>> _cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    public:
+        void cancel()             { _cancelled->store(true, std::memory_order_relaxed); }
+        bool isCancelled() const  { return _cancelled->load(std::memory_order_relaxed); }
+};
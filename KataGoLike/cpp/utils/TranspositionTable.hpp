@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @brief A thread safe map from the key of a position to its node, the first node inserted for a key is kept.
+ *
+ * The keys are split into shards by their low bits, every shard has its own lock,
+ * so the search threads rarely wait for each other.
+ */
+template<typename TNode>
+class TranspositionTable
+{
+private:
+    static constexpr std::size_t SHARD_NUM = 64;
+
+    struct Shard
+    {
+        std::mutex                             mutex{};
+        std::unordered_map<uint64_t, TNode*>   nodes{};
+    };
+
+    std::array<Shard, SHARD_NUM> _shards{};
+
+public:
+    TranspositionTable() = default;
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Insert a node if there is no node of the key.
+     * @param key: the key of the position.
+     * @param node: the node of the position.
+     * @return TNode*: the node of the key, the given one if it is inserted.
+     */
+    TNode* insert(uint64_t key, TNode* node)
+    {
+        auto& shard = _shards[key % SHARD_NUM];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.nodes.emplace(key, node).first->second;
+    }
+
+    /**
+     * @brief Find the node of a key.
+     * @param key: the key of the position.
+     * @return TNode*: the node of the key, nullptr if there is none.
+     */
+    TNode* find(uint64_t key)
+    {
+        auto& shard = _shards[key % SHARD_NUM];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.nodes.find(key);
+        return (found == shard.nodes.end()) ? nullptr : found->second;
+    }
+
+    void clear()
+    {
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.nodes.clear();
+        }
+    }
+};
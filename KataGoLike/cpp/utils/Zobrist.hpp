@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "../constant.h"
+
+// The Zobrist keys of a N * N board, ZOBRIST_TABLE<N>[stone - 1][i * N + j] is the key of a stone at (i, j).
+// The hash of a position is the xor of the keys of all stones on the board,
+// so it can be updated incrementally when a stone is placed or removed.
+// https://en.wikipedia.org/wiki/Zobrist_hashing
+template<int N>
+using BasicZobristTable = std::array<std::array<uint64_t, N * N>, 2>;
+
+// https://prng.di.unimi.it/splitmix64.c
+constexpr uint64_t splitMix64(uint64_t& state)
+{
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+template<int N>
+constexpr BasicZobristTable<N> makeZobristTable()
+{
+    BasicZobristTable<N> table{};
+    uint64_t state = 0x5A5A5A5A5A5A5A5AULL;
+    for (auto& row : table)
+    {
+        for (auto& key : row)
+        {
+            key = splitMix64(state);
+        }
+    }
+    return table;
+}
+
+template<int N>
+inline constexpr BasicZobristTable<N> ZOBRIST_TABLE = makeZobristTable<N>();
+
+/**
+ * @brief Get the Zobrist key of a stone at a specific point.
+ * @param stone: the color of the stone, 1 for black, 2 for white.
+ * @param i: the row index of the point.
+ * @param j: the column index of the point.
+ * @return uint64_t: the key.
+ */
+template<int N = BOARD_SIZE>
+constexpr uint64_t zobristKey(int stone, int i, int j)
+{
+    return ZOBRIST_TABLE<N>[stone - 1][i * N + j];
+}